@@ -21,6 +21,13 @@
  *  glBindVertexArray(objVAO);
  *  glDrawArrays(GL_TRIANGLES, 0, nVertices);
  *
+ *  Os exercícios não usam mais esta cópia: ligam com a biblioteca ObjLoader
+ *  (include/glad/ObjLoader.h), que tem a mesma assinatura de loadSimpleOBJ,
+ *  lê o arquivo mapeado em memória sem std::istringstream e devolve também
+ *  coordenadas de textura e normais. Esta versão fica como material de aula
+ *  (explicada passo a passo em LoadSimpleOBJ.md) e como referência de tempo
+ *  para o ObjBench.
+ *
  */
 
  // Cabeçalhos necessários (para esta função), acrescentar ao seu código 
@@ -0,0 +1,276 @@
+#include "AppWindow.h"
+#include "Camera.h"
+#include "CameraTrack.h"
+#include "ImageCompare.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const double HEADLESS_FRAME_TIME = 1.0 / 60.0;
+
+bool headless = false;
+bool uncapped = false;
+int frameLimit = 0; // 0 = até fechar a janela
+int frameCount = 0;
+std::string capturePath;
+GLuint framebuffer = 0, colorBuffer = 0, depthBuffer = 0;
+std::chrono::steady_clock::time_point lastPresent;
+std::vector<double> frameMs; // frameMs[i] é o quadro i + 1: o quadro 0 inclui a carga dos arquivos
+std::string frameTimesPath;
+CameraTrack cameraPath;       // --camera-play
+CameraTrackWriter cameraRecord; // --camera-record
+
+GLFWwindow* createWindow(int width, int height, const char* title)
+{
+    if (headless)
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    return glfwCreateWindow(width, height, title, nullptr, nullptr);
+}
+
+// Plataforma nula: sem servidor gráfico, o contexto vem da EGL (ou OSMesa)
+GLFWwindow* createNullPlatformWindow(int width, int height, const char* title)
+{
+#ifdef GLFW_PLATFORM_NULL
+    if (!glfwPlatformSupported(GLFW_PLATFORM_NULL))
+        return nullptr;
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    if (glfwInit()) {
+        const int apis[] = {GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API};
+        for (int api : apis) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, api);
+            GLFWwindow* window = createWindow(width, height, title);
+            if (window)
+                return window;
+        }
+        glfwTerminate();
+    }
+    // Volta para a plataforma normal (janela oculta); glfwInit reinicia as dicas de janela
+    glfwInitHint(GLFW_PLATFORM, GLFW_ANY_PLATFORM);
+#endif
+    return nullptr;
+}
+
+bool createFramebuffer(int width, int height)
+{
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "FBO do modo headless incompleto" << std::endl;
+        return false;
+    }
+    // Fica vinculado: os exercícios nunca trocam de framebuffer
+    return true;
+}
+
+// Framebuffer atual (o FBO no modo headless, o back buffer com janela)
+void captureFrame(GLFWwindow* window)
+{
+    RgbaImage image;
+    glfwGetFramebufferSize(window, &image.width, &image.height);
+    std::vector<uint8_t> rows((size_t)image.width * image.height * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, image.width, image.height, GL_RGBA, GL_UNSIGNED_BYTE, rows.data());
+
+    // A OpenGL devolve de baixo para cima
+    size_t stride = (size_t)image.width * 4;
+    image.pixels.resize(rows.size());
+    for (int y = 0; y < image.height; ++y)
+        std::copy(rows.begin() + (image.height - 1 - y) * stride, rows.begin() + (image.height - y) * stride,
+                  image.pixels.begin() + y * stride);
+    if (savePng(capturePath, image))
+        std::cout << "Quadro " << frameCount << " gravado em " << capturePath << std::endl;
+}
+
+void printFrameReport()
+{
+    if (frameMs.empty())
+        return;
+    std::vector<double> sorted(frameMs);
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (double ms : sorted)
+        total += ms;
+    double average = total / sorted.size();
+    std::cout << sorted.size() << " quadros (sem o primeiro) em " << total << " ms: média " << average << " ms ("
+              << 1000.0 / average << " quadros/s), mín " << sorted.front() << " ms, p99 "
+              << sorted[(size_t)(0.99 * (sorted.size() - 1))] << " ms, máx " << sorted.back() << " ms" << std::endl;
+
+    // No percurso, os quadros mais lentos dizem quais vistas custam mais
+    if (!cameraPath.empty()) {
+        std::vector<size_t> order(frameMs.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        size_t shown = std::min<size_t>(5, order.size());
+        std::partial_sort(order.begin(), order.begin() + shown, order.end(),
+                          [](size_t a, size_t b) { return frameMs[a] > frameMs[b]; });
+        std::cout << "Quadros mais lentos do percurso:" << std::endl;
+        for (size_t i = 0; i < shown; ++i) {
+            const CameraKey& key = cameraPath.key(order[i] + 1);
+            std::cout << "  quadro " << order[i] + 1 << ": " << frameMs[order[i]] << " ms, câmera (" << key.position.x
+                      << ", " << key.position.y << ", " << key.position.z << ") yaw " << key.yaw << " pitch "
+                      << key.pitch << std::endl;
+        }
+    }
+}
+
+void writeFrameTimes()
+{
+    FILE* file = fopen(frameTimesPath.c_str(), "w");
+    if (!file) {
+        std::cerr << "Não foi possível gravar " << frameTimesPath << std::endl;
+        return;
+    }
+    fprintf(file, cameraPath.empty() ? "quadro,ms\n" : "quadro,ms,x,y,z,yaw,pitch\n");
+    for (size_t i = 0; i < frameMs.size(); ++i) {
+        fprintf(file, "%zu,%.4f", i + 1, frameMs[i]);
+        if (!cameraPath.empty()) {
+            const CameraKey& key = cameraPath.key(i + 1);
+            fprintf(file, ",%.9g,%.9g,%.9g,%.9g,%.9g", key.position.x, key.position.y, key.position.z, key.yaw,
+                    key.pitch);
+        }
+        fprintf(file, "\n");
+    }
+    fclose(file);
+    std::cout << "Tempos de " << frameMs.size() << " quadros gravados em " << frameTimesPath << std::endl;
+}
+
+} // namespace
+
+void parseAppOptions(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--headless") == 0)
+            headless = true;
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frameLimit = std::max(0, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+            capturePath = argv[++i];
+        else if (strcmp(argv[i], "--uncapped") == 0)
+            uncapped = true;
+        else if (strcmp(argv[i], "--camera-record") == 0 && i + 1 < argc)
+            cameraRecord.open(argv[++i]);
+        else if (strcmp(argv[i], "--camera-play") == 0 && i + 1 < argc) {
+            if (cameraPath.load(argv[++i]))
+                std::cout << "Percurso da câmera: " << cameraPath.size() << " quadros de " << argv[i] << std::endl;
+        }
+        else if (strcmp(argv[i], "--frame-times") == 0 && i + 1 < argc)
+            frameTimesPath = argv[++i];
+    }
+    if (frameLimit == 0 && !cameraPath.empty())
+        frameLimit = (int)cameraPath.size();
+    if (!capturePath.empty() && frameLimit == 0)
+        frameLimit = 1;
+}
+
+bool appHeadless()
+{
+    return headless;
+}
+
+GLuint appFramebuffer()
+{
+    return framebuffer;
+}
+
+GLFWwindow* createAppWindow(int width, int height, const char* title)
+{
+    GLFWwindow* window = headless ? createNullPlatformWindow(width, height, title) : nullptr;
+    if (!window) {
+        if (!glfwInit()) {
+            std::cerr << "Falha ao inicializar GLFW" << std::endl;
+            return nullptr;
+        }
+        window = createWindow(width, height, title);
+        if (!window) {
+            std::cerr << "Falha ao criar janela GLFW" << std::endl;
+            glfwTerminate();
+            return nullptr;
+        }
+    }
+
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Falha ao inicializar GLAD" << std::endl;
+        glfwTerminate();
+        return nullptr;
+    }
+
+    // Sem janela não há o que sincronizar; com --uncapped o quadro não espera o vsync
+    if (headless || uncapped)
+        glfwSwapInterval(0);
+    if (headless) {
+        if (!createFramebuffer(width, height)) {
+            glfwTerminate();
+            return nullptr;
+        }
+        glfwSetTime(0.0);
+        std::cout << "Modo headless: " << width << "x" << height << ", " << glGetString(GL_RENDERER) << std::endl;
+    }
+    return window;
+}
+
+void presentFrame(GLFWwindow* window)
+{
+    if (!capturePath.empty() && frameCount + 1 == frameLimit)
+        captureFrame(window);
+
+    if (headless) {
+        // Sem superfície para trocar: só garante que o quadro foi executado
+        glFinish();
+        glfwSetTime((frameCount + 1) * HEADLESS_FRAME_TIME);
+    } else {
+        glfwSwapBuffers(window);
+    }
+
+    frameCount++;
+    if (frameLimit == 0)
+        return;
+
+    // O relógio começa no fim do primeiro quadro, que também paga a carga de
+    // malhas, texturas e shaders e distorceria média, máximo e p99
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (frameCount > 1)
+        frameMs.push_back(std::chrono::duration<double, std::milli>(now - lastPresent).count());
+    lastPresent = now;
+    if (frameCount >= frameLimit) {
+        printFrameReport();
+        if (!frameTimesPath.empty())
+            writeFrameTimes();
+        cameraRecord.close();
+        glfwSetWindowShouldClose(window, true);
+    }
+}
+
+bool driveCamera(Camera& camera)
+{
+    return driveCamera(camera, camera.Position);
+}
+
+bool driveCamera(Camera& camera, const glm::vec3& shownPosition)
+{
+    if (!cameraPath.empty()) {
+        cameraPath.apply(camera, (size_t)frameCount);
+        cameraRecord.write(camera);
+        return true;
+    }
+    cameraRecord.write(camera, shownPosition);
+    return false;
+}
@@ -0,0 +1,179 @@
+#include "Bounds.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+MeshBounds computeBounds(const float* vertices, size_t vertexCount, size_t stride)
+{
+    MeshBounds bounds;
+    if (vertexCount == 0)
+        return bounds;
+
+    bounds.min = bounds.max = glm::vec3(vertices[0], vertices[1], vertices[2]);
+    for (size_t i = 1; i < vertexCount; ++i) {
+        const float* p = vertices + i * stride;
+        bounds.min = glm::vec3(std::min(bounds.min.x, p[0]), std::min(bounds.min.y, p[1]), std::min(bounds.min.z, p[2]));
+        bounds.max = glm::vec3(std::max(bounds.max.x, p[0]), std::max(bounds.max.y, p[1]), std::max(bounds.max.z, p[2]));
+    }
+    bounds.center = (bounds.min + bounds.max) * 0.5f;
+
+    // Mais justa que a meia diagonal da AABB
+    float radius2 = 0.0f;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const float* p = vertices + i * stride;
+        glm::vec3 d = glm::vec3(p[0], p[1], p[2]) - bounds.center;
+        radius2 = std::max(radius2, d.x * d.x + d.y * d.y + d.z * d.z);
+    }
+    bounds.radius = std::sqrt(radius2);
+    return bounds;
+}
+
+Frustum extractFrustum(const glm::mat4& m)
+{
+    // Linha i da matriz (glm guarda por colunas)
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; ++i)
+        row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+    Frustum frustum;
+    frustum.planes[0] = row[3] + row[0];
+    frustum.planes[1] = row[3] - row[0];
+    frustum.planes[2] = row[3] + row[1];
+    frustum.planes[3] = row[3] - row[1];
+    frustum.planes[4] = row[3] + row[2];
+    frustum.planes[5] = row[3] - row[2];
+    for (glm::vec4& plane : frustum.planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f)
+            plane = plane / length;
+    }
+    return frustum;
+}
+
+bool sphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius)
+{
+    for (const glm::vec4& plane : frustum.planes) {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+void transformSphere(const MeshBounds& bounds, const glm::mat4& model, glm::vec3& center, float& radius)
+{
+    glm::vec4 c = model * glm::vec4(bounds.center, 1.0f);
+    center = glm::vec3(c.x, c.y, c.z);
+    float sx = model[0].x * model[0].x + model[0].y * model[0].y + model[0].z * model[0].z;
+    float sy = model[1].x * model[1].x + model[1].y * model[1].y + model[1].z * model[1].z;
+    float sz = model[2].x * model[2].x + model[2].y * model[2].y + model[2].z * model[2].z;
+    radius = bounds.radius * std::sqrt(std::max(sx, std::max(sy, sz)));
+}
+
+Aabb transformAabb(const MeshBounds& bounds, const glm::mat4& model)
+{
+    Aabb box;
+    box.min = box.max = glm::vec3(model[3].x, model[3].y, model[3].z);
+    for (int column = 0; column < 3; ++column) {
+        for (int row = 0; row < 3; ++row) {
+            float a = model[column][row] * bounds.min[column];
+            float b = model[column][row] * bounds.max[column];
+            box.min[row] += std::min(a, b);
+            box.max[row] += std::max(a, b);
+        }
+    }
+    return box;
+}
+
+Aabb mergeAabb(const Aabb& a, const Aabb& b)
+{
+    Aabb box;
+    box.min = glm::vec3(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z));
+    box.max = glm::vec3(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z));
+    return box;
+}
+
+float surfaceArea(const Aabb& box)
+{
+    glm::vec3 d = box.max - box.min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+FrustumTest classifyAabb(const Frustum& frustum, const Aabb& box)
+{
+    FrustumTest result = FRUSTUM_INSIDE;
+    for (const glm::vec4& plane : frustum.planes) {
+        // Vértice mais à frente (positivo) e mais atrás (negativo) na direção da normal
+        glm::vec3 positive(plane.x >= 0.0f ? box.max.x : box.min.x,
+                           plane.y >= 0.0f ? box.max.y : box.min.y,
+                           plane.z >= 0.0f ? box.max.z : box.min.z);
+        glm::vec3 negative(plane.x >= 0.0f ? box.min.x : box.max.x,
+                           plane.y >= 0.0f ? box.min.y : box.max.y,
+                           plane.z >= 0.0f ? box.min.z : box.max.z);
+        if (plane.x * positive.x + plane.y * positive.y + plane.z * positive.z + plane.w < 0.0f)
+            return FRUSTUM_OUTSIDE;
+        if (plane.x * negative.x + plane.y * negative.y + plane.z * negative.z + plane.w < 0.0f)
+            result = FRUSTUM_INTERSECTS;
+    }
+    return result;
+}
+
+bool rayIntersectsAabb(const glm::vec3& origin, const glm::vec3& invDirection, const Aabb& box,
+                       float maxDistance, float& distance)
+{
+    float tmin = 0.0f, tmax = maxDistance;
+    for (int axis = 0; axis < 3; ++axis) {
+        float t0 = (box.min[axis] - origin[axis]) * invDirection[axis];
+        float t1 = (box.max[axis] - origin[axis]) * invDirection[axis];
+        if (t0 > t1)
+            std::swap(t0, t1);
+        // Com direção 0 no eixo, t0/t1 são +-inf (ou NaN na borda): a comparação falha para o lado seguro
+        tmin = t0 > tmin ? t0 : tmin;
+        tmax = t1 < tmax ? t1 : tmax;
+        if (tmin > tmax)
+            return false;
+    }
+    distance = tmin;
+    return true;
+}
+
+size_t cullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+                   size_t count, uint32_t* visible)
+{
+    size_t visibleCount = 0;
+    size_t i = 0;
+#ifdef __SSE2__
+    __m128 px[6], py[6], pz[6], pd[6];
+    for (int p = 0; p < 6; ++p) {
+        px[p] = _mm_set1_ps(frustum.planes[p].x);
+        py[p] = _mm_set1_ps(frustum.planes[p].y);
+        pz[p] = _mm_set1_ps(frustum.planes[p].z);
+        pd[p] = _mm_set1_ps(frustum.planes[p].w);
+    }
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 cx = _mm_loadu_ps(x + i), cy = _mm_loadu_ps(y + i), cz = _mm_loadu_ps(z + i);
+        __m128 negRadius = _mm_sub_ps(zero, _mm_loadu_ps(radius + i));
+        __m128 outside = zero;
+        for (int p = 0; p < 6; ++p) {
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px[p], cx), _mm_mul_ps(py[p], cy)),
+                                         _mm_add_ps(_mm_mul_ps(pz[p], cz), pd[p]));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negRadius));
+        }
+        int mask = ~_mm_movemask_ps(outside) & 0xF;
+        // Escrita sem desvio: o índice é gravado sempre e só avança se visível
+        for (int k = 0; k < 4; ++k) {
+            visible[visibleCount] = (uint32_t)(i + k);
+            visibleCount += (mask >> k) & 1;
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        if (sphereInFrustum(frustum, glm::vec3(x[i], y[i], z[i]), radius[i]))
+            visible[visibleCount++] = (uint32_t)i;
+    }
+    return visibleCount;
+}
@@ -0,0 +1,263 @@
+#include "Bvh.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <numeric>
+
+namespace {
+
+const uint32_t LEAF_OBJECTS = 4;  // abaixo disso não vale dividir
+const uint32_t MAX_LEAF_OBJECTS = 16;
+const int SAH_BINS = 12;
+
+bool sameBox(const Aabb& a, const Aabb& b)
+{
+    return a.min.x == b.min.x && a.min.y == b.min.y && a.min.z == b.min.z &&
+           a.max.x == b.max.x && a.max.y == b.max.y && a.max.z == b.max.z;
+}
+
+} // namespace
+
+Aabb Bvh::boundsOf(uint32_t first, uint32_t count) const
+{
+    Aabb box = Boxes[Objects[first]];
+    for (uint32_t i = first + 1; i < first + count; ++i)
+        box = mergeAabb(box, Boxes[Objects[i]]);
+    return box;
+}
+
+void Bvh::build(const Aabb* boxes, size_t count)
+{
+    Boxes.assign(boxes, boxes + count);
+    Objects.resize(count);
+    std::iota(Objects.begin(), Objects.end(), 0u);
+    LeafOf.assign(count, 0);
+    Nodes.clear();
+    if (count == 0)
+        return;
+
+    std::vector<glm::vec3> centroids(count);
+    for (size_t i = 0; i < count; ++i)
+        centroids[i] = (Boxes[i].min + Boxes[i].max) * 0.5f;
+
+    Nodes.reserve(2 * count);
+    Node root;
+    root.count = (uint32_t)count;
+    root.box = boundsOf(0, root.count);
+    Nodes.push_back(root);
+
+    // Pilha explícita: a profundidade depende da distribuição dos objetos
+    std::vector<uint32_t> pending(1, 0);
+    while (!pending.empty()) {
+        uint32_t node = pending.back();
+        pending.pop_back();
+        split(node, centroids);
+        if (Nodes[node].left) {
+            pending.push_back(Nodes[node].left);
+            pending.push_back(Nodes[node].left + 1);
+        }
+    }
+
+    for (uint32_t n = 0; n < Nodes.size(); ++n) {
+        if (Nodes[n].left == 0) {
+            for (uint32_t i = Nodes[n].first; i < Nodes[n].first + Nodes[n].count; ++i)
+                LeafOf[Objects[i]] = n;
+        }
+    }
+}
+
+void Bvh::split(uint32_t node, const std::vector<glm::vec3>& centroids)
+{
+    uint32_t first = Nodes[node].first, count = Nodes[node].count;
+    if (count <= LEAF_OBJECTS)
+        return;
+
+    glm::vec3 cmin = centroids[Objects[first]], cmax = cmin;
+    for (uint32_t i = first + 1; i < first + count; ++i) {
+        const glm::vec3& c = centroids[Objects[i]];
+        cmin = glm::vec3(std::min(cmin.x, c.x), std::min(cmin.y, c.y), std::min(cmin.z, c.z));
+        cmax = glm::vec3(std::max(cmax.x, c.x), std::max(cmax.y, c.y), std::max(cmax.z, c.z));
+    }
+    glm::vec3 extent = cmax - cmin;
+    int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+    uint32_t middle = first + count / 2;
+    Aabb leftBox, rightBox;
+    bool haveBoxes = false;
+    if (extent[axis] > 0.0f) {
+        // SAH em faixas: custo de cada corte = objetos * área de cada lado
+        float scale = SAH_BINS / extent[axis];
+        Aabb binBox[SAH_BINS];
+        uint32_t binCount[SAH_BINS] = {};
+        for (uint32_t i = first; i < first + count; ++i) {
+            int bin = std::min(SAH_BINS - 1, (int)((centroids[Objects[i]][axis] - cmin[axis]) * scale));
+            binBox[bin] = binCount[bin]++ ? mergeAabb(binBox[bin], Boxes[Objects[i]]) : Boxes[Objects[i]];
+        }
+
+        Aabb rightBoxes[SAH_BINS];
+        uint32_t rightCount[SAH_BINS];
+        Aabb accumulated;
+        uint32_t accumulatedCount = 0;
+        for (int bin = SAH_BINS - 1; bin > 0; --bin) {
+            if (binCount[bin])
+                accumulated = accumulatedCount ? mergeAabb(accumulated, binBox[bin]) : binBox[bin];
+            accumulatedCount += binCount[bin];
+            rightBoxes[bin] = accumulated;
+            rightCount[bin] = accumulatedCount;
+        }
+
+        float bestCost = FLT_MAX;
+        int bestBin = -1;
+        accumulatedCount = 0;
+        for (int bin = 0; bin < SAH_BINS - 1; ++bin) {
+            if (binCount[bin])
+                accumulated = accumulatedCount ? mergeAabb(accumulated, binBox[bin]) : binBox[bin];
+            accumulatedCount += binCount[bin];
+            if (accumulatedCount == 0 || rightCount[bin + 1] == 0)
+                continue;
+            float cost = accumulatedCount * surfaceArea(accumulated) + rightCount[bin + 1] * surfaceArea(rightBoxes[bin + 1]);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestBin = bin;
+                leftBox = accumulated;
+            }
+        }
+
+        // Folha se nenhum corte compensar (e ela não ficar grande demais)
+        float leafCost = count * surfaceArea(Nodes[node].box);
+        if (bestBin >= 0 && bestCost >= leafCost && count <= MAX_LEAF_OBJECTS)
+            return;
+
+        if (bestBin >= 0) {
+            uint32_t* begin = Objects.data() + first;
+            uint32_t* end = begin + count;
+            middle = (uint32_t)(std::partition(begin, end, [&](uint32_t object) {
+                return std::min(SAH_BINS - 1, (int)((centroids[object][axis] - cmin[axis]) * scale)) <= bestBin;
+            }) - Objects.data());
+            // As caixas dos filhos já saíram da varredura das faixas
+            rightBox = rightBoxes[bestBin + 1];
+            haveBoxes = true;
+        }
+    } else if (count <= MAX_LEAF_OBJECTS) {
+        return;
+    }
+    // Centroides coincidentes (ou sem corte útil): divide pela metade
+    if (middle == first || middle == first + count) {
+        middle = first + count / 2;
+        haveBoxes = false;
+    }
+
+    uint32_t left = (uint32_t)Nodes.size();
+    Node child;
+    child.parent = node;
+    child.first = first;
+    child.count = middle - first;
+    child.box = haveBoxes ? leftBox : boundsOf(child.first, child.count);
+    Nodes.push_back(child);
+    child.first = middle;
+    child.count = first + count - middle;
+    child.box = haveBoxes ? rightBox : boundsOf(child.first, child.count);
+    Nodes.push_back(child);
+    Nodes[node].left = left;
+}
+
+void Bvh::update(uint32_t object, const Aabb& box)
+{
+    Boxes[object] = box;
+    uint32_t node = LeafOf[object];
+    Nodes[node].box = boundsOf(Nodes[node].first, Nodes[node].count);
+
+    // Sobe até a raiz, parando quando a caixa de um ancestral não muda
+    while (node != 0) {
+        node = Nodes[node].parent;
+        Aabb merged = mergeAabb(Nodes[Nodes[node].left].box, Nodes[Nodes[node].left + 1].box);
+        if (sameBox(merged, Nodes[node].box))
+            break;
+        Nodes[node].box = merged;
+    }
+}
+
+size_t Bvh::cull(const Frustum& frustum, std::vector<uint32_t>& visible) const
+{
+    size_t before = visible.size();
+    if (Nodes.empty())
+        return 0;
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        uint32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = Nodes[index];
+
+        FrustumTest test = classifyAabb(frustum, node.box);
+        if (test == FRUSTUM_OUTSIDE)
+            continue;
+        if (test == FRUSTUM_INSIDE) {
+            visible.insert(visible.end(), Objects.begin() + node.first, Objects.begin() + node.first + node.count);
+        } else if (node.left == 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                if (classifyAabb(frustum, Boxes[Objects[i]]) != FRUSTUM_OUTSIDE)
+                    visible.push_back(Objects[i]);
+            }
+        } else {
+            stack.push_back(node.left + 1);
+            stack.push_back(node.left);
+        }
+    }
+    return visible.size() - before;
+}
+
+int Bvh::pick(const glm::vec3& origin, const glm::vec3& direction, float& distance) const
+{
+    if (Nodes.empty())
+        return -1;
+
+    glm::vec3 invDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+    float best = FLT_MAX;
+    int bestObject = -1;
+
+    std::vector<std::pair<float, uint32_t>> pending;
+    float t;
+    if (rayIntersectsAabb(origin, invDirection, Nodes[0].box, best, t))
+        pending.push_back(std::make_pair(t, 0u));
+    while (!pending.empty()) {
+        std::pair<float, uint32_t> entry = pending.back();
+        pending.pop_back();
+        if (entry.first >= best)
+            continue;
+        const Node& node = Nodes[entry.second];
+
+        if (node.left == 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                if (rayIntersectsAabb(origin, invDirection, Boxes[Objects[i]], best, t) && t < best) {
+                    best = t;
+                    bestObject = (int)Objects[i];
+                }
+            }
+            continue;
+        }
+
+        // Filho mais próximo por último na pilha: é visitado primeiro e encurta best
+        float tLeft, tRight;
+        bool hitLeft = rayIntersectsAabb(origin, invDirection, Nodes[node.left].box, best, tLeft);
+        bool hitRight = rayIntersectsAabb(origin, invDirection, Nodes[node.left + 1].box, best, tRight);
+        if (hitLeft && hitRight) {
+            if (tLeft < tRight) {
+                pending.push_back(std::make_pair(tRight, node.left + 1));
+                pending.push_back(std::make_pair(tLeft, node.left));
+            } else {
+                pending.push_back(std::make_pair(tLeft, node.left));
+                pending.push_back(std::make_pair(tRight, node.left + 1));
+            }
+        } else if (hitLeft) {
+            pending.push_back(std::make_pair(tLeft, node.left));
+        } else if (hitRight) {
+            pending.push_back(std::make_pair(tRight, node.left + 1));
+        }
+    }
+
+    distance = best;
+    return bestObject;
+}
@@ -0,0 +1,106 @@
+#include "CameraTrack.h"
+#include "Camera.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+CameraKey keyOf(const Camera& camera)
+{
+    CameraKey key;
+    key.position = camera.Position;
+    key.yaw = camera.Yaw;
+    key.pitch = camera.Pitch;
+    return key;
+}
+
+void writeKey(FILE* file, const CameraKey& key)
+{
+    fprintf(file, "%.9g %.9g %.9g %.9g %.9g\n", key.position.x, key.position.y, key.position.z, key.yaw, key.pitch);
+}
+
+} // namespace
+
+bool CameraTrack::load(const std::string& filePath)
+{
+    std::ifstream file(filePath);
+    if (!file) {
+        std::cerr << "Não foi possível abrir o percurso da câmera: " << filePath << std::endl;
+        return false;
+    }
+    std::vector<CameraKey> keys;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+        std::istringstream values(line);
+        CameraKey key;
+        if (!(values >> key.position.x >> key.position.y >> key.position.z >> key.yaw >> key.pitch)) {
+            std::cerr << filePath << ":" << lineNumber << ": esperado \"x y z yaw pitch\"" << std::endl;
+            return false;
+        }
+        keys.push_back(key);
+    }
+    Keys.swap(keys);
+    return true;
+}
+
+const CameraKey& CameraTrack::key(size_t frame) const
+{
+    return Keys[frame < Keys.size() ? frame : Keys.size() - 1];
+}
+
+void CameraTrack::apply(Camera& camera, size_t frame) const
+{
+    if (Keys.empty())
+        return;
+    const CameraKey& k = key(frame);
+    camera.SetView(k.position, k.yaw, k.pitch);
+}
+
+CameraTrackWriter::~CameraTrackWriter()
+{
+    close();
+}
+
+bool CameraTrackWriter::open(const std::string& filePath)
+{
+    close();
+    File = fopen(filePath.c_str(), "w");
+    if (!File) {
+        std::cerr << "Não foi possível gravar o percurso da câmera: " << filePath << std::endl;
+        return false;
+    }
+    Written = 0;
+    fprintf(File, "# x y z yaw pitch\n");
+    return true;
+}
+
+void CameraTrackWriter::write(const Camera& camera)
+{
+    write(camera, camera.Position);
+}
+
+void CameraTrackWriter::write(const Camera& camera, const glm::vec3& position)
+{
+    if (!File)
+        return;
+    CameraKey key = keyOf(camera);
+    key.position = position;
+    writeKey(File, key);
+    fflush(File);
+    Written++;
+}
+
+void CameraTrackWriter::close()
+{
+    if (File) {
+        fclose(File);
+        File = nullptr;
+    }
+}
@@ -0,0 +1,57 @@
+#include "FixedStep.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Tolerância relativa ao passo: relógios como k/60 acumulados em double podem
+// ficar um ulp abaixo de um múltiplo exato, o que daria 0 passos num quadro e
+// 2 no seguinte
+const double STEP_EPSILON = 1e-6;
+
+} // namespace
+
+FixedStep::FixedStep(double hz, int maxSteps)
+    : MaxSteps(std::max(1, maxSteps))
+{
+    setRate(hz);
+}
+
+void FixedStep::setRate(double hz)
+{
+    Hz = hz > 0.0 ? hz : 60.0;
+    Step = 1.0 / Hz;
+}
+
+int FixedStep::advance(double now)
+{
+    if (!Started) {
+        Started = true;
+        Last = now;
+        return 0;
+    }
+    Accumulator += std::max(0.0, now - Last);
+    Last = now;
+
+    int steps = (int)std::floor(Accumulator / Step + STEP_EPSILON);
+    if (steps > MaxSteps) {
+        DroppedTime += (steps - MaxSteps) * Step;
+        Accumulator -= (steps - MaxSteps) * Step;
+        steps = MaxSteps;
+    }
+    Accumulator = std::max(0.0, Accumulator - steps * Step);
+    TotalSteps += steps;
+    return steps;
+}
+
+float FixedStep::alpha() const
+{
+    return (float)std::min(1.0, Accumulator / Step);
+}
+
+void FixedStep::reset()
+{
+    Started = false;
+    Accumulator = 0.0;
+}
@@ -0,0 +1,343 @@
+#include "FrameRecorder.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include <stb_image_write.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// QOI ("Quite OK Image", qoiformat.org): sem perdas, uma passada e poucas
+// comparações por pixel; ordem de grandeza mais rápido que PNG.
+const uint8_t QOI_OP_INDEX = 0x00, QOI_OP_DIFF = 0x40, QOI_OP_LUMA = 0x80, QOI_OP_RUN = 0xc0;
+const uint8_t QOI_OP_RGB = 0xfe, QOI_OP_RGBA = 0xff;
+
+void putBigEndian32(std::vector<uint8_t>& out, uint32_t value)
+{
+    out.push_back((uint8_t)(value >> 24));
+    out.push_back((uint8_t)(value >> 16));
+    out.push_back((uint8_t)(value >> 8));
+    out.push_back((uint8_t)value);
+}
+
+// rows: RGBA de baixo para cima (glReadPixels); o arquivo sai de cima para baixo
+void encodeQoi(const uint8_t* rows, int width, int height, std::vector<uint8_t>& out)
+{
+    out.clear();
+    out.reserve((size_t)width * height * 2 + 22);
+    out.insert(out.end(), {'q', 'o', 'i', 'f'});
+    putBigEndian32(out, (uint32_t)width);
+    putBigEndian32(out, (uint32_t)height);
+    out.push_back(4); // RGBA
+    out.push_back(0); // sRGB com alfa linear
+
+    uint8_t index[64][4] = {};
+    uint8_t previous[4] = {0, 0, 0, 255};
+    int run = 0;
+    size_t stride = (size_t)width * 4;
+    for (int y = height - 1; y >= 0; --y) {
+        const uint8_t* row = rows + y * stride;
+        for (int x = 0; x < width; ++x) {
+            const uint8_t* px = row + 4 * x;
+            if (memcmp(px, previous, 4) == 0) {
+                if (++run == 62) {
+                    out.push_back(QOI_OP_RUN | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                out.push_back(QOI_OP_RUN | (run - 1));
+                run = 0;
+            }
+
+            int hash = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+            if (memcmp(index[hash], px, 4) == 0) {
+                out.push_back(QOI_OP_INDEX | hash);
+            } else {
+                memcpy(index[hash], px, 4);
+                if (px[3] == previous[3]) {
+                    int dr = (int8_t)(px[0] - previous[0]);
+                    int dg = (int8_t)(px[1] - previous[1]);
+                    int db = (int8_t)(px[2] - previous[2]);
+                    int drg = dr - dg, dbg = db - dg;
+                    if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                        out.push_back(QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                    } else if (drg >= -8 && drg <= 7 && dg >= -32 && dg <= 31 && dbg >= -8 && dbg <= 7) {
+                        out.push_back(QOI_OP_LUMA | (dg + 32));
+                        out.push_back((uint8_t)((drg + 8) << 4 | (dbg + 8)));
+                    } else {
+                        out.insert(out.end(), {QOI_OP_RGB, px[0], px[1], px[2]});
+                    }
+                } else {
+                    out.insert(out.end(), {QOI_OP_RGBA, px[0], px[1], px[2], px[3]});
+                }
+            }
+            memcpy(previous, px, 4);
+        }
+    }
+    if (run > 0)
+        out.push_back(QOI_OP_RUN | (run - 1));
+    out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+}
+
+// BT.601 em faixa limitada (o padrão do Y4M), planos Y, U e V completos (4:4:4)
+void rgbaToYuv444(const uint8_t* rows, int width, int height, std::vector<uint8_t>& yuv)
+{
+    size_t planeSize = (size_t)width * height;
+    yuv.resize(planeSize * 3);
+    uint8_t* py = yuv.data();
+    uint8_t* pu = py + planeSize;
+    uint8_t* pv = pu + planeSize;
+    size_t stride = (size_t)width * 4;
+    for (int y = height - 1; y >= 0; --y) {
+        const uint8_t* px = rows + y * stride;
+        for (int x = 0; x < width; ++x, px += 4) {
+            int r = px[0], g = px[1], b = px[2];
+            *py++ = (uint8_t)(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+            *pu++ = (uint8_t)(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+            *pv++ = (uint8_t)(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+        }
+    }
+}
+
+std::string frameFileName(size_t index, const char* extension)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "quadro_%06zu.%s", index, extension);
+    return name;
+}
+
+} // namespace
+
+bool parseCaptureFormat(const std::string& name, CaptureFormat& format)
+{
+    if (name == "png")
+        format = CAPTURE_PNG;
+    else if (name == "qoi")
+        format = CAPTURE_QOI;
+    else if (name == "y4m")
+        format = CAPTURE_Y4M;
+    else
+        return false;
+    return true;
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    stop();
+}
+
+bool FrameRecorder::start(const std::string& outputPath, CaptureFormat format, int width, int height,
+                          int fps, int ringSize, size_t maxQueued)
+{
+    stop();
+    Format = format;
+    OutputPath = outputPath;
+    Width = width;
+    Height = height;
+    FrameBytes = (size_t)width * height * 4;
+    MaxQueued = maxQueued > 0 ? maxQueued : 1;
+    Captured = Dropped = 0;
+    Written = 0;
+    CaptureMs = 0.0;
+
+    if (format == CAPTURE_Y4M) {
+        Video = fopen(outputPath.c_str(), "wb");
+        if (!Video) {
+            std::cerr << "Falha ao criar " << outputPath << std::endl;
+            return false;
+        }
+        fprintf(Video, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", width, height, fps);
+    } else {
+        std::error_code ec;
+        fs::create_directories(outputPath, ec);
+        if (ec) {
+            std::cerr << "Falha ao criar a pasta " << outputPath << ": " << ec.message() << std::endl;
+            return false;
+        }
+    }
+
+    Ring.assign(ringSize > 0 ? ringSize : 1, Slot());
+    for (Slot& slot : Ring) {
+        glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, FrameBytes, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    NextSlot = 0;
+
+    Stopping = false;
+    Writer = std::thread(&FrameRecorder::writerLoop, this);
+    Recording = true;
+    std::cout << "Gravando " << width << "x" << height << " em " << outputPath << std::endl;
+    return true;
+}
+
+void FrameRecorder::capture()
+{
+    if (!Recording)
+        return;
+    auto start = std::chrono::steady_clock::now();
+
+    // O slot mais antigo do anel: a cópia dele já deve ter terminado
+    Slot& slot = Ring[NextSlot];
+    if (slot.fence)
+        readSlot(slot);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.frame = Captured++;
+    NextSlot = (NextSlot + 1) % Ring.size();
+
+    CaptureMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void FrameRecorder::readSlot(Slot& slot)
+{
+    // Só espera de verdade se a GPU estiver mais de ringSize - 1 quadros atrás
+    GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+    glDeleteSync(slot.fence);
+    slot.fence = 0;
+    if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+        Dropped++;
+        return;
+    }
+
+    Frame frame;
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        if (Queue.size() >= MaxQueued) {
+            Dropped++; // escrita atrasada: perde o quadro, não o tempo de quadro
+            return;
+        }
+        if (!FreeFrames.empty()) {
+            frame = std::move(FreeFrames.back());
+            FreeFrames.pop_back();
+        }
+    }
+    frame.index = slot.frame;
+    frame.pixels.resize(FrameBytes);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    const void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, FrameBytes, GL_MAP_READ_BIT);
+    if (data) {
+        memcpy(frame.pixels.data(), data, FrameBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!data) {
+        Dropped++;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Queue.push_back(std::move(frame));
+    }
+    Available.notify_one();
+}
+
+void FrameRecorder::writerLoop()
+{
+    std::vector<Frame> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(Mutex);
+            Available.wait(lock, [this] { return Stopping || !Queue.empty(); });
+            if (Queue.empty())
+                return;
+            while (!Queue.empty()) {
+                batch.push_back(std::move(Queue.front()));
+                Queue.pop_front();
+            }
+        }
+
+        // Y4M é um arquivo só, em ordem; PNG/QOI são independentes e codificam em paralelo
+        if (Format == CAPTURE_Y4M) {
+            for (Frame& frame : batch)
+                writeFrame(frame);
+        } else {
+            ThreadPool::shared().parallelFor(batch.size(), [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                    writeFrame(batch[i]);
+            });
+        }
+        Written += batch.size();
+
+        std::lock_guard<std::mutex> lock(Mutex);
+        for (Frame& frame : batch)
+            FreeFrames.push_back(std::move(frame));
+        batch.clear();
+    }
+}
+
+void FrameRecorder::writeFrame(Frame& frame)
+{
+    if (Format == CAPTURE_Y4M) {
+        thread_local std::vector<uint8_t> yuv;
+        rgbaToYuv444(frame.pixels.data(), Width, Height, yuv);
+        fputs("FRAME\n", Video);
+        fwrite(yuv.data(), 1, yuv.size(), Video);
+        return;
+    }
+
+    fs::path path = fs::path(OutputPath) / frameFileName(frame.index, Format == CAPTURE_PNG ? "png" : "qoi");
+    if (Format == CAPTURE_PNG) {
+        // stb_image_write aceita passo negativo: começa na última linha e sobe
+        size_t stride = (size_t)Width * 4;
+        const uint8_t* top = frame.pixels.data() + (Height - 1) * stride;
+        if (!stbi_write_png(path.string().c_str(), Width, Height, 4, top, -(int)stride))
+            std::cerr << "Falha ao gravar " << path.string() << std::endl;
+        return;
+    }
+
+    thread_local std::vector<uint8_t> encoded;
+    encodeQoi(frame.pixels.data(), Width, Height, encoded);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write((const char*)encoded.data(), (std::streamsize)encoded.size());
+    if (!file)
+        std::cerr << "Falha ao gravar " << path.string() << std::endl;
+}
+
+void FrameRecorder::stop()
+{
+    if (!Recording)
+        return;
+
+    // Quadros ainda no anel, do mais antigo ao mais novo
+    for (size_t k = 0; k < Ring.size(); ++k) {
+        Slot& slot = Ring[(NextSlot + k) % Ring.size()];
+        if (slot.fence)
+            readSlot(slot);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Stopping = true;
+    }
+    Available.notify_all();
+    Writer.join();
+
+    for (Slot& slot : Ring)
+        glDeleteBuffers(1, &slot.pbo);
+    Ring.clear();
+    FreeFrames.clear();
+    if (Video) {
+        fclose(Video);
+        Video = nullptr;
+    }
+    Recording = false;
+
+    std::cout << "Gravação: " << Written << " quadros em " << OutputPath << ", " << Dropped << " descartados, captura "
+              << (Captured > 0 ? CaptureMs / Captured : 0.0) << " ms/quadro" << std::endl;
+}
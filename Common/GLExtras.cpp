@@ -0,0 +1,17 @@
+#include "GLExtras.h"
+
+PFNGLGETPROGRAMBINARYPROC glextras_glGetProgramBinary = nullptr;
+PFNGLPROGRAMBINARYPROC glextras_glProgramBinary = nullptr;
+PFNGLPROGRAMPARAMETERIPROC glextras_glProgramParameteri = nullptr;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC glextras_glMultiDrawElementsIndirect = nullptr;
+
+bool loadGLExtras(GLADloadproc load)
+{
+    glextras_glGetProgramBinary = (PFNGLGETPROGRAMBINARYPROC)load("glGetProgramBinary");
+    glextras_glProgramBinary = (PFNGLPROGRAMBINARYPROC)load("glProgramBinary");
+    glextras_glProgramParameteri = (PFNGLPROGRAMPARAMETERIPROC)load("glProgramParameteri");
+    glextras_glMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)load("glMultiDrawElementsIndirect");
+
+    return glextras_glGetProgramBinary || glextras_glProgramBinary || glextras_glProgramParameteri ||
+           glextras_glMultiDrawElementsIndirect;
+}
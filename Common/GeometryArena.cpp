@@ -0,0 +1,209 @@
+#include "GeometryArena.h"
+#include "InstanceBuffer.h"
+#include "GLExtras.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+GeometryArena::GeometryArena(size_t vertexCapacity, size_t indexCapacity)
+    : VertexCapacity(std::max<size_t>(vertexCapacity, 1)), IndexCapacity(std::max<size_t>(indexCapacity, 1))
+{
+}
+
+GeometryArena::~GeometryArena()
+{
+    release();
+}
+
+void GeometryArena::create()
+{
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, VertexCapacity * OBJ_VERTEX_STRIDE * sizeof(GLfloat), nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndexCapacity * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)0);
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(1);
+
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)(5 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+// Novos buffers com o conteúdo atual copiado na GPU; o VAO passa a apontar
+// para eles (atributos de instância ligados ao VAO não mudam)
+void GeometryArena::grow(size_t vertices, size_t indices)
+{
+    size_t vertexCapacity = VertexCapacity, indexCapacity = IndexCapacity;
+    while (vertexCapacity < vertices)
+        vertexCapacity *= 2;
+    while (indexCapacity < indices)
+        indexCapacity *= 2;
+
+    glBindVertexArray(VAO);
+    if (vertexCapacity != VertexCapacity) {
+        GLuint buffer;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, vertexCapacity * OBJ_VERTEX_STRIDE * sizeof(GLfloat), nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_READ_BUFFER, VBO);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, VertexCount * OBJ_VERTEX_STRIDE * sizeof(GLfloat));
+        glDeleteBuffers(1, &VBO);
+        VBO = buffer;
+        VertexCapacity = vertexCapacity;
+
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)(5 * sizeof(GLfloat)));
+    }
+    if (indexCapacity != IndexCapacity) {
+        GLuint buffer;
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, indexCapacity * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_READ_BUFFER, EBO);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, IndexCount * sizeof(GLuint));
+        glDeleteBuffers(1, &EBO);
+        EBO = buffer;
+        IndexCapacity = indexCapacity;
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+ArenaMesh GeometryArena::add(const GLfloat* vertices, size_t vertexCount, const GLuint* indices, size_t indexCount)
+{
+    if (!VAO)
+        create();
+    if (VertexCount + vertexCount > VertexCapacity || IndexCount + indexCount > IndexCapacity)
+        grow(VertexCount + vertexCount, IndexCount + indexCount);
+
+    ArenaMesh mesh;
+    mesh.firstIndex = (GLuint)IndexCount;
+    mesh.indexCount = (GLuint)indexCount;
+    mesh.baseVertex = (GLint)VertexCount;
+    mesh.bounds = computeBounds(vertices, vertexCount, OBJ_VERTEX_STRIDE);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, VertexCount * OBJ_VERTEX_STRIDE * sizeof(GLfloat),
+                    vertexCount * OBJ_VERTEX_STRIDE * sizeof(GLfloat), vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    // Sem VAO vinculado, GL_ELEMENT_ARRAY_BUFFER não altera o estado de nenhum VAO
+    glBindVertexArray(0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, IndexCount * sizeof(GLuint), indexCount * sizeof(GLuint), indices);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    VertexCount += vertexCount;
+    IndexCount += indexCount;
+    return mesh;
+}
+
+ArenaMesh GeometryArena::add(const OBJMesh& mesh)
+{
+    return add(mesh.vBuffer.data(), mesh.vBuffer.size() / OBJ_VERTEX_STRIDE, mesh.indices.data(), mesh.indices.size());
+}
+
+void GeometryArena::release()
+{
+    if (VAO) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        glDeleteBuffers(1, &EBO);
+    }
+    VAO = VBO = EBO = 0;
+    VertexCount = IndexCount = 0;
+}
+
+bool loadOBJ(const std::string& filePath, GeometryArena& arena, ArenaMesh& arenaMesh, OBJMaterial* material)
+{
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+
+    OBJMesh mesh;
+    if (!parseOBJ(filePath, mesh))
+        return false;
+
+    if (material && mesh.hasMaterial)
+        *material = mesh.material;
+
+    arenaMesh = arena.add(mesh);
+    std::cout << "Malha " << filePath << " lida para a arena em "
+              << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << std::endl;
+    return true;
+}
+
+void IndirectBatch::add(const ArenaMesh& mesh, GLuint instanceCount, GLuint baseInstance)
+{
+    DrawElementsIndirectCommand command;
+    command.count = mesh.indexCount;
+    command.instanceCount = instanceCount;
+    command.firstIndex = mesh.firstIndex;
+    command.baseVertex = mesh.baseVertex;
+    command.baseInstance = baseInstance;
+    Commands.push_back(command);
+}
+
+void IndirectBatch::draw(const GeometryArena& arena, InstanceBuffer* instances)
+{
+    if (Commands.empty())
+        return;
+
+    if (!Buffer)
+        glGenBuffers(1, &Buffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, Buffer);
+    GLsizeiptr bytes = (GLsizeiptr)(Commands.size() * sizeof(DrawElementsIndirectCommand));
+    if (Commands.size() > Capacity) {
+        Capacity = Commands.size();
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, bytes, Commands.data(), GL_DYNAMIC_DRAW);
+    } else {
+        // Órfão: os comandos do quadro anterior podem ainda estar em uso
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, (GLsizeiptr)(Capacity * sizeof(DrawElementsIndirectCommand)), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, bytes, Commands.data());
+    }
+
+    glBindVertexArray(arena.vao());
+    if (glMultiDrawElementsIndirect) {
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (GLvoid *)0, (GLsizei)Commands.size(), 0);
+    } else {
+        // Antes da 4.2 o baseInstance do comando precisa ser 0: a primeira
+        // instância de cada malha vem dos ponteiros dos atributos
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        for (const DrawElementsIndirectCommand& command : Commands) {
+            if (instances)
+                instances->setFirstInstance(command.baseInstance);
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei)command.count, GL_UNSIGNED_INT,
+                                              (GLvoid *)(command.firstIndex * sizeof(GLuint)),
+                                              (GLsizei)command.instanceCount, command.baseVertex);
+        }
+        if (instances)
+            instances->setFirstInstance(0);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void IndirectBatch::release()
+{
+    if (Buffer)
+        glDeleteBuffers(1, &Buffer);
+    Buffer = 0;
+    Capacity = 0;
+}
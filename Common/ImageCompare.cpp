@@ -0,0 +1,118 @@
+#include "ImageCompare.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+#include <stb_image.h>
+#include <stb_image_write.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+bool loadPng(const std::string& filePath, RgbaImage& image)
+{
+    int width, height, channels;
+    unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &channels, 4);
+    if (!data)
+        return false;
+    image.width = width;
+    image.height = height;
+    image.pixels.assign(data, data + (size_t)width * height * 4);
+    stbi_image_free(data);
+    return true;
+}
+
+bool savePng(const std::string& filePath, const RgbaImage& image)
+{
+    if (!stbi_write_png(filePath.c_str(), image.width, image.height, 4, image.pixels.data(), image.width * 4)) {
+        std::cerr << "Falha ao gravar " << filePath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+ImageDiff compareImages(const RgbaImage& a, const RgbaImage& b, int tolerance)
+{
+    ImageDiff result;
+    size_t count = (size_t)a.width * a.height;
+    const uint8_t* pa = a.pixels.data();
+    const uint8_t* pb = b.pixels.data();
+    tolerance = std::max(0, std::min(255, tolerance));
+
+    uint64_t squaredSum = 0;
+    size_t i = 0;
+#ifdef __SSE2__
+    // Quatro pixels por vez: |a - b| por byte com duas subtrações saturadas
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i limit = _mm_set1_epi8((char)tolerance);
+    __m128i maxDifference = zero;
+    while (i + 4 <= count) {
+        // Somas de 32 bits esvaziadas a cada 4096 iterações (4 * 255^2 por iteração e faixa)
+        size_t blockEnd = std::min(count & ~(size_t)3, i + 4 * 4096);
+        __m128i sum = zero;
+        for (; i < blockEnd; i += 4) {
+            __m128i va = _mm_loadu_si128((const __m128i*)(pa + 4 * i));
+            __m128i vb = _mm_loadu_si128((const __m128i*)(pb + 4 * i));
+            __m128i difference = _mm_and_si128(_mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va)), rgbMask);
+            maxDifference = _mm_max_epu8(maxDifference, difference);
+
+            // Pixel igual se nenhum canal passa da tolerância (os 32 bits zerados)
+            __m128i over = _mm_subs_epu8(difference, limit);
+            int same = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(over, zero)));
+            result.differentPixels += 4 - ((same & 1) + ((same >> 1) & 1) + ((same >> 2) & 1) + ((same >> 3) & 1));
+
+            __m128i low = _mm_unpacklo_epi8(difference, zero);
+            __m128i high = _mm_unpackhi_epi8(difference, zero);
+            sum = _mm_add_epi32(sum, _mm_add_epi32(_mm_madd_epi16(low, low), _mm_madd_epi16(high, high)));
+        }
+        uint32_t lanes[4];
+        _mm_storeu_si128((__m128i*)lanes, sum);
+        squaredSum += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    uint8_t maxBytes[16];
+    _mm_storeu_si128((__m128i*)maxBytes, maxDifference);
+    for (uint8_t value : maxBytes)
+        result.maxDifference = std::max(result.maxDifference, (int)value);
+#endif
+    for (; i < count; ++i) {
+        bool different = false;
+        for (int c = 0; c < 3; ++c) {
+            int difference = std::abs((int)pa[4 * i + c] - (int)pb[4 * i + c]);
+            result.maxDifference = std::max(result.maxDifference, difference);
+            squaredSum += (uint64_t)(difference * difference);
+            different |= difference > tolerance;
+        }
+        result.differentPixels += different;
+    }
+
+    double mse = count > 0 ? (double)squaredSum / (count * 3.0) : 0.0;
+    result.psnr = mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : std::numeric_limits<double>::infinity();
+    return result;
+}
+
+RgbaImage diffImage(const RgbaImage& a, const RgbaImage& b, int tolerance)
+{
+    RgbaImage diff;
+    diff.width = a.width;
+    diff.height = a.height;
+    diff.pixels.resize(a.pixels.size());
+    for (size_t i = 0; i < a.pixels.size(); i += 4) {
+        int difference = 0;
+        for (int c = 0; c < 3; ++c)
+            difference = std::max(difference, std::abs((int)a.pixels[i + c] - (int)b.pixels[i + c]));
+        if (difference > tolerance) {
+            diff.pixels[i] = 255;
+            diff.pixels[i + 1] = diff.pixels[i + 2] = 0;
+        } else {
+            uint8_t gray = (uint8_t)((a.pixels[i] * 77 + a.pixels[i + 1] * 150 + a.pixels[i + 2] * 29) >> 10);
+            diff.pixels[i] = diff.pixels[i + 1] = diff.pixels[i + 2] = gray;
+        }
+        diff.pixels[i + 3] = 255;
+    }
+    return diff;
+}
@@ -0,0 +1,83 @@
+#include "InstanceBuffer.h"
+
+#include <algorithm>
+
+void InstanceBuffer::attach(GLuint VAO)
+{
+    if (!Buffer)
+        glGenBuffers(1, &Buffer);
+
+    glBindVertexArray(VAO);
+    setFirstInstance(0);
+    for (GLuint attribute = INSTANCE_ATTRIB; attribute < INSTANCE_ATTRIB + 5; ++attribute) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    glBindVertexArray(0);
+}
+
+void InstanceBuffer::setFirstInstance(size_t first)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, Buffer);
+    const GLsizei stride = sizeof(InstanceData);
+    const size_t base = first * sizeof(InstanceData);
+    for (GLuint column = 0; column < 4; ++column) {
+        glVertexAttribPointer(INSTANCE_ATTRIB + column, 4, GL_FLOAT, GL_FALSE, stride,
+                              (GLvoid *)(base + offsetof(InstanceData, model) + column * sizeof(glm::vec4)));
+    }
+    glVertexAttribPointer(INSTANCE_ATTRIB + 4, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid *)(base + offsetof(InstanceData, color)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::update(const InstanceData* data, size_t count)
+{
+    if (!Buffer)
+        glGenBuffers(1, &Buffer);
+
+    glBindBuffer(GL_ARRAY_BUFFER, Buffer);
+    if (count > Capacity) {
+        Capacity = count;
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(Capacity * sizeof(InstanceData)), data, GL_DYNAMIC_DRAW);
+    } else {
+        // Órfão: o driver não precisa esperar o quadro anterior terminar de ler
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(Capacity * sizeof(InstanceData)), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(count * sizeof(InstanceData)), data);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    Count = count;
+}
+
+InstanceData* InstanceBuffer::map(size_t count)
+{
+    Count = 0;
+    if (count == 0)
+        return nullptr;
+    if (!Buffer)
+        glGenBuffers(1, &Buffer);
+
+    glBindBuffer(GL_ARRAY_BUFFER, Buffer);
+    Capacity = std::max(Capacity, count);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(Capacity * sizeof(InstanceData)), nullptr, GL_DYNAMIC_DRAW);
+    void* data = glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(count * sizeof(InstanceData)),
+                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (data)
+        Count = count;
+    return (InstanceData*)data;
+}
+
+void InstanceBuffer::unmap()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, Buffer);
+    if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+        Count = 0; // conteúdo perdido (troca de modo de vídeo etc.): não desenha lixo
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstanceBuffer::release()
+{
+    if (Buffer)
+        glDeleteBuffers(1, &Buffer);
+    Buffer = 0;
+    Count = Capacity = 0;
+}
@@ -0,0 +1,155 @@
+#include "KtxFile.h"
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const unsigned char KTX_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+const uint32_t KTX_ENDIANNESS = 0x04030201;
+
+struct KtxHeader {
+    unsigned char identifier[12];
+    uint32_t endianness;
+    uint32_t glType;
+    uint32_t glTypeSize;
+    uint32_t glFormat;
+    uint32_t glInternalFormat;
+    uint32_t glBaseInternalFormat;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t numberOfArrayElements;
+    uint32_t numberOfFaces;
+    uint32_t numberOfMipmapLevels;
+    uint32_t bytesOfKeyValueData;
+};
+
+size_t alignTo4(size_t size)
+{
+    return (size + 3) & ~(size_t)3;
+}
+
+// Com withData = false só os formatos e os níveis (tamanhos) são lidos
+bool readKTXFile(const std::string& filePath, KtxImage& image, bool withData)
+{
+    MappedFile file;
+    if (!file.open(filePath) || file.size() < sizeof(KtxHeader))
+        return false;
+
+    KtxHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER)) != 0 || header.endianness != KTX_ENDIANNESS)
+        return false;
+    // Só texturas 2D simples (sem profundidade, arrays ou cubemaps)
+    if (header.pixelHeight == 0 || header.pixelDepth > 1 || header.numberOfArrayElements > 0 || header.numberOfFaces != 1)
+        return false;
+
+    image.internalFormat = header.glInternalFormat;
+    image.format = header.glFormat;
+    image.type = header.glType;
+    image.baseFormat = header.glBaseInternalFormat;
+    image.levels.clear();
+    image.data.clear();
+
+    size_t offset = sizeof(KtxHeader) + header.bytesOfKeyValueData;
+    uint32_t levelCount = header.numberOfMipmapLevels > 0 ? header.numberOfMipmapLevels : 1;
+    int width = (int)header.pixelWidth, height = (int)header.pixelHeight;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        uint32_t imageSize;
+        if (offset + sizeof(imageSize) > file.size())
+            return false;
+        memcpy(&imageSize, file.data() + offset, sizeof(imageSize));
+        offset += sizeof(imageSize);
+        if (offset + imageSize > file.size())
+            return false;
+
+        KtxLevel entry;
+        entry.width = width;
+        entry.height = height;
+        entry.offset = image.data.size();
+        entry.size = imageSize;
+        if (withData)
+            image.data.insert(image.data.end(), file.data() + offset, file.data() + offset + imageSize);
+        image.levels.push_back(entry);
+
+        offset = alignTo4(offset + imageSize);
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return true;
+}
+
+} // namespace
+
+bool readKTX(const std::string& filePath, KtxImage& image)
+{
+    return readKTXFile(filePath, image, true);
+}
+
+bool readKTXInfo(const std::string& filePath, KtxImage& image)
+{
+    return readKTXFile(filePath, image, false);
+}
+
+size_t KtxImage::levelBytes() const
+{
+    size_t total = 0;
+    for (const KtxLevel& level : levels)
+        total += level.size;
+    return total;
+}
+
+bool writeKTX(const std::string& filePath, const KtxImage& image)
+{
+    if (image.levels.empty())
+        return false;
+
+    KtxHeader header = {};
+    memcpy(header.identifier, KTX_IDENTIFIER, sizeof(KTX_IDENTIFIER));
+    header.endianness = KTX_ENDIANNESS;
+    header.glType = image.type;
+    header.glTypeSize = 1; // dados em bytes: nada a inverter em outra endianness
+    header.glFormat = image.format;
+    header.glInternalFormat = image.internalFormat;
+    header.glBaseInternalFormat = image.baseFormat;
+    header.pixelWidth = (uint32_t)image.levels[0].width;
+    header.pixelHeight = (uint32_t)image.levels[0].height;
+    header.numberOfFaces = 1;
+    header.numberOfMipmapLevels = (uint32_t)image.levels.size();
+
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+    file.write((const char*)&header, sizeof(header));
+
+    const char padding[4] = {0, 0, 0, 0};
+    for (const KtxLevel& level : image.levels) {
+        uint32_t imageSize = (uint32_t)level.size;
+        file.write((const char*)&imageSize, sizeof(imageSize));
+        file.write((const char*)image.data.data() + level.offset, (std::streamsize)level.size);
+        file.write(padding, (std::streamsize)(alignTo4(level.size) - level.size));
+    }
+    return (bool)file;
+}
+
+std::string bakedTexturePath(const std::string& imagePath)
+{
+    fs::path baked = fs::path(imagePath).replace_extension(".ktx");
+    if (baked == fs::path(imagePath))
+        return imagePath;
+
+    std::error_code ec;
+    fs::file_time_type bakedTime = fs::last_write_time(baked, ec);
+    if (ec)
+        return std::string();
+    fs::file_time_type sourceTime = fs::last_write_time(imagePath, ec);
+    if (!ec && sourceTime > bakedTime)
+        return std::string(); // imagem editada depois do último TexBake
+    return baked.string();
+}
@@ -0,0 +1,141 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other) {
+        close();
+        std::swap(Data, other.Data);
+        std::swap(Size, other.Size);
+        std::swap(Opened, other.Opened);
+#ifdef _WIN32
+        std::swap(FileHandle, other.FileHandle);
+        std::swap(MappingHandle, other.MappingHandle);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filePath)
+{
+    close();
+
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    FileHandle = file;
+    Size = (size_t)fileSize.QuadPart;
+    Opened = true;
+    if (Size == 0)
+        return true;
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        close();
+        return false;
+    }
+    MappingHandle = mapping;
+
+    Data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!Data) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (Data)
+        UnmapViewOfFile(Data);
+    if (MappingHandle)
+        CloseHandle((HANDLE)MappingHandle);
+    if (FileHandle)
+        CloseHandle((HANDLE)FileHandle);
+    Data = nullptr;
+    MappingHandle = nullptr;
+    FileHandle = nullptr;
+    Size = 0;
+    Opened = false;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filePath)
+{
+    close();
+
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    Size = (size_t)st.st_size;
+    Opened = true;
+    if (Size == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    void* addr = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // O mapeamento continua válido depois de fechar o descritor
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        Size = 0;
+        Opened = false;
+        return false;
+    }
+
+    madvise(addr, Size, MADV_SEQUENTIAL);
+    Data = (const char*)addr;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (Data)
+        munmap((void*)Data, Size);
+    Data = nullptr;
+    Size = 0;
+    Opened = false;
+}
+
+#endif
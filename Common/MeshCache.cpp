@@ -0,0 +1,282 @@
+#include "MeshCache.h"
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Layout atual dos vértices gerados pelo ObjLoader
+const MeshCacheAttribute CURRENT_ATTRIBUTES[] = {
+    {0, 3, 0},
+    {1, 2, 3 * sizeof(GLfloat)},
+    {2, 3, 5 * sizeof(GLfloat)},
+};
+const uint32_t CURRENT_ATTRIBUTE_COUNT = sizeof(CURRENT_ATTRIBUTES) / sizeof(CURRENT_ATTRIBUTES[0]);
+
+struct FileStamp {
+    bool exists = false;
+    uint64_t size = 0;
+    int64_t mtime = 0;
+};
+
+FileStamp stampOf(const std::string& path)
+{
+    FileStamp stamp;
+    std::error_code ec;
+    uint64_t size = fs::file_size(path, ec);
+    if (ec)
+        return stamp;
+    fs::file_time_type mtime = fs::last_write_time(path, ec);
+    if (ec)
+        return stamp;
+    stamp.exists = true;
+    stamp.size = size;
+    stamp.mtime = (int64_t)mtime.time_since_epoch().count();
+    return stamp;
+}
+
+size_t alignTo16(size_t offset)
+{
+    return (offset + 15) & ~(size_t)15;
+}
+
+void appendBytes(std::vector<char>& out, const void* data, size_t size)
+{
+    const char* bytes = (const char*)data;
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+void appendString(std::vector<char>& out, const std::string& str)
+{
+    uint32_t length = (uint32_t)str.size();
+    appendBytes(out, &length, sizeof(length));
+    appendBytes(out, str.data(), str.size());
+}
+
+bool readString(const char*& p, const char* end, std::string& str)
+{
+    uint32_t length;
+    if ((size_t)(end - p) < sizeof(length))
+        return false;
+    memcpy(&length, p, sizeof(length));
+    p += sizeof(length);
+    if ((size_t)(end - p) < length)
+        return false;
+    str.assign(p, length);
+    p += length;
+    return true;
+}
+
+bool readFloatField(const char*& p, const char* end, float& value)
+{
+    if ((size_t)(end - p) < sizeof(value))
+        return false;
+    memcpy(&value, p, sizeof(value));
+    p += sizeof(value);
+    return true;
+}
+
+// Cache corrompido ou gravado por outro programa não pode apontar para fora dos vértices
+template <typename Index>
+bool indicesInRange(const char* data, uint32_t count, uint32_t nVertices)
+{
+    for (uint32_t i = 0; i < count; ++i) {
+        Index index;
+        memcpy(&index, data + (size_t)i * sizeof(Index), sizeof(Index));
+        if (index >= nVertices)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+uint64_t hashBytes(const void* data, size_t size)
+{
+    // Variante de FNV-1a que consome 8 bytes por iteração
+    const uint64_t prime = 0x100000001B3ull;
+    uint64_t h = 0xCBF29CE484222325ull ^ (uint64_t)size;
+    const unsigned char* p = (const unsigned char*)data;
+
+    size_t words = size / 8;
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t word;
+        memcpy(&word, p + i * 8, 8);
+        h = (h ^ word) * prime;
+        h ^= h >> 29;
+    }
+    for (size_t i = words * 8; i < size; ++i)
+        h = (h ^ p[i]) * prime;
+
+    return h ^ (h >> 32);
+}
+
+std::string meshCachePath(const std::string& objPath)
+{
+    return objPath + ".meshbin";
+}
+
+bool writeMeshCache(const std::string& objPath, const OBJMesh& mesh)
+{
+    MappedFile source;
+    if (!source.open(objPath))
+        return false;
+    FileStamp objStamp = stampOf(objPath);
+
+    MeshCacheHeader header = {};
+    header.magic = MESH_CACHE_MAGIC;
+    header.version = MESH_CACHE_VERSION;
+    header.sourceSize = objStamp.size;
+    header.sourceMtime = objStamp.mtime;
+    header.sourceHash = hashBytes(source.data(), source.size());
+    source.close();
+
+    if (mesh.hasMaterial) {
+        FileStamp mtlStamp = stampOf(mesh.mtlFile);
+        header.mtlSize = mtlStamp.size;
+        header.mtlMtime = mtlStamp.mtime;
+    }
+
+    header.vertexStride = OBJ_VERTEX_STRIDE * sizeof(GLfloat);
+    header.attributeCount = CURRENT_ATTRIBUTE_COUNT;
+    header.nVertices = (uint32_t)mesh.nVertices;
+    header.nIndices = (uint32_t)mesh.nIndices;
+    header.indexSize = mesh.nVertices <= 0xFFFF ? sizeof(GLushort) : sizeof(GLuint);
+    header.hasMaterial = mesh.hasMaterial ? 1 : 0;
+
+    std::vector<char> out(sizeof(MeshCacheHeader));
+    appendBytes(out, CURRENT_ATTRIBUTES, sizeof(CURRENT_ATTRIBUTES));
+
+    header.materialOffset = out.size();
+    appendString(out, mesh.mtlFile);
+    appendString(out, mesh.material.mapKd);
+    appendBytes(out, &mesh.material.ka, sizeof(float));
+    appendBytes(out, &mesh.material.kd, sizeof(float));
+    appendBytes(out, &mesh.material.ks, sizeof(float));
+    appendBytes(out, &mesh.material.ns, sizeof(float));
+
+    header.vertexOffset = alignTo16(out.size());
+    header.vertexBytes = mesh.vBuffer.size() * sizeof(GLfloat);
+    out.resize(header.vertexOffset);
+    appendBytes(out, mesh.vBuffer.data(), header.vertexBytes);
+
+    header.indexOffset = alignTo16(out.size());
+    out.resize(header.indexOffset);
+    if (header.indexSize == sizeof(GLushort)) {
+        std::vector<GLushort> shortIndices(mesh.indices.begin(), mesh.indices.end());
+        header.indexBytes = shortIndices.size() * sizeof(GLushort);
+        appendBytes(out, shortIndices.data(), header.indexBytes);
+    } else {
+        header.indexBytes = mesh.indices.size() * sizeof(GLuint);
+        appendBytes(out, mesh.indices.data(), header.indexBytes);
+    }
+
+    memcpy(out.data(), &header, sizeof(header));
+
+    // Grava em um arquivo temporário e renomeia, para nunca deixar um cache pela metade
+    std::string cachePath = meshCachePath(objPath);
+    std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+        file.write(out.data(), (std::streamsize)out.size());
+        if (!file)
+            return false;
+    }
+    std::error_code ec;
+    fs::rename(tmpPath, cachePath, ec);
+    if (ec) {
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool loadMeshCache(const std::string& objPath, GLMesh& glMesh, OBJMaterial* material)
+{
+    MappedFile cache;
+    if (!cache.open(meshCachePath(objPath)) || cache.size() < sizeof(MeshCacheHeader))
+        return false;
+
+    MeshCacheHeader header;
+    memcpy(&header, cache.data(), sizeof(header));
+    if (header.magic != MESH_CACHE_MAGIC || header.version != MESH_CACHE_VERSION)
+        return false;
+
+    // Layout diferente do atual (versão antiga do ObjLoader): descarta
+    if (header.vertexStride != OBJ_VERTEX_STRIDE * sizeof(GLfloat) ||
+        header.attributeCount != CURRENT_ATTRIBUTE_COUNT ||
+        cache.size() < sizeof(MeshCacheHeader) + sizeof(CURRENT_ATTRIBUTES) ||
+        memcmp(cache.data() + sizeof(MeshCacheHeader), CURRENT_ATTRIBUTES, sizeof(CURRENT_ATTRIBUTES)) != 0)
+        return false;
+
+    const char* end = cache.data() + cache.size();
+    if (header.vertexOffset + header.vertexBytes > cache.size() ||
+        header.indexOffset + header.indexBytes > cache.size() ||
+        header.materialOffset > cache.size() ||
+        (header.indexSize != sizeof(GLushort) && header.indexSize != sizeof(GLuint)) ||
+        header.vertexBytes != (uint64_t)header.nVertices * header.vertexStride ||
+        header.indexBytes != (uint64_t)header.nIndices * header.indexSize)
+        return false;
+
+    FileStamp objStamp = stampOf(objPath);
+    if (!objStamp.exists || objStamp.size != header.sourceSize)
+        return false;
+    bool touched = objStamp.mtime != header.sourceMtime;
+    if (touched) {
+        // Arquivo "tocado" (checkout, cópia): só o conteúdo importa
+        MappedFile source;
+        if (!source.open(objPath) || hashBytes(source.data(), source.size()) != header.sourceHash)
+            return false;
+    }
+
+    OBJMaterial cachedMaterial;
+    std::string mtlFile;
+    const char* p = cache.data() + header.materialOffset;
+    if (!readString(p, end, mtlFile) || !readString(p, end, cachedMaterial.mapKd) ||
+        !readFloatField(p, end, cachedMaterial.ka) || !readFloatField(p, end, cachedMaterial.kd) ||
+        !readFloatField(p, end, cachedMaterial.ks) || !readFloatField(p, end, cachedMaterial.ns))
+        return false;
+
+    // O .mtl é lido relativo ao diretório atual, como no parseOBJ; se ele mudou
+    // (ou passou a existir/deixou de existir) o cache é refeito
+    if (!mtlFile.empty()) {
+        FileStamp mtlStamp = stampOf(mtlFile);
+        if (mtlStamp.exists != (header.hasMaterial != 0))
+            return false;
+        if (mtlStamp.exists && (mtlStamp.size != header.mtlSize || mtlStamp.mtime != header.mtlMtime))
+            return false;
+    }
+
+    const char* indices = cache.data() + header.indexOffset;
+    if (header.indexSize == sizeof(GLushort) ? !indicesInRange<GLushort>(indices, header.nIndices, header.nVertices)
+                                             : !indicesInRange<GLuint>(indices, header.nIndices, header.nVertices))
+        return false;
+
+    if (material && header.hasMaterial)
+        *material = cachedMaterial;
+
+    glMesh = uploadMesh(cache.data() + header.vertexOffset, header.vertexBytes,
+                        indices, header.indexBytes,
+                        header.indexSize == sizeof(GLushort) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                        (GLsizei)header.nIndices);
+
+    // Conteúdo confirmado pelo hash: grava a data nova no cabeçalho, para as
+    // próximas execuções não relerem o .obj inteiro. Falhar aqui não é fatal.
+    if (touched) {
+        cache.close();
+        std::fstream file(meshCachePath(objPath), std::ios::in | std::ios::out | std::ios::binary);
+        if (file.is_open()) {
+            file.seekp((std::streamoff)offsetof(MeshCacheHeader, sourceMtime));
+            file.write((const char*)&objStamp.mtime, sizeof(objStamp.mtime));
+        }
+    }
+    return true;
+}
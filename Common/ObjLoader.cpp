@@ -0,0 +1,725 @@
+#include "ObjLoader.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+struct Vec3f { float x, y, z; };
+struct Vec2f { float s, t; };
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipBlanks(const char* p, const char* end)
+{
+    while (p < end && isBlank(*p))
+        ++p;
+    return p;
+}
+
+inline const char* findLineEnd(const char* p, const char* end)
+{
+    const char* nl = (const char*)memchr(p, '\n', (size_t)(end - p));
+    return nl ? nl : end;
+}
+
+// Lê um float a partir de p (após espaços). Em caso de erro mantém out e p.
+inline bool readFloat(const char*& p, const char* end, float& out)
+{
+    const char* q = skipBlanks(p, end);
+    if (q < end && *q == '+')
+        ++q;
+    std::from_chars_result r = std::from_chars(q, end, out);
+    if (r.ec != std::errc())
+        return false;
+    p = r.ptr;
+    return true;
+}
+
+inline bool readInt(const char*& p, const char* end, int& out)
+{
+    if (p < end && *p == '+')
+        ++p;
+    std::from_chars_result r = std::from_chars(p, end, out);
+    if (r.ec != std::errc())
+        return false;
+    p = r.ptr;
+    return true;
+}
+
+// Palavra-chave no início da linha (v, vt, vn, f, mtllib...)
+inline bool keywordIs(const char* word, size_t len, const char* keyword)
+{
+    return strlen(keyword) == len && memcmp(word, keyword, len) == 0;
+}
+
+// Resto da linha sem espaços nas pontas (nomes de arquivo)
+inline std::string restOfLine(const char* p, const char* end)
+{
+    p = skipBlanks(p, end);
+    while (end > p && isBlank(end[-1]))
+        --end;
+    return std::string(p, end);
+}
+
+// Um vértice de face: v, v/vt, v//vn ou v/vt/vn. Índices ausentes ficam em 0.
+inline bool readFaceCorner(const char*& p, const char* end, int& vi, int& ti, int& ni)
+{
+    vi = ti = ni = 0;
+    if (!readInt(p, end, vi))
+        return false;
+    if (p < end && *p == '/') {
+        ++p;
+        if (p < end && *p != '/')
+            readInt(p, end, ti);
+        if (p < end && *p == '/') {
+            ++p;
+            readInt(p, end, ni);
+        }
+    }
+    return true;
+}
+
+// Tabela hash (endereçamento aberto) de triplas v/vt/vn -> índice do vértice único.
+// Evita a alocação por nó de std::unordered_map.
+class CornerTable {
+public:
+    explicit CornerTable(size_t expected)
+    {
+        size_t capacity = 64;
+        while (capacity < expected * 2)
+            capacity <<= 1;
+        Slots.assign(capacity, Slot());
+        Mask = capacity - 1;
+    }
+
+    // Retorna o índice existente ou insere 'next' e devolve-o
+    GLuint findOrInsert(int vi, int ti, int ni, GLuint next, bool& inserted)
+    {
+        if ((Count + 1) * 2 > Slots.size())
+            grow();
+
+        size_t i = hash(vi, ti, ni) & Mask;
+        while (true) {
+            Slot& s = Slots[i];
+            if (!s.used) {
+                s = Slot{vi, ti, ni, next, true};
+                ++Count;
+                inserted = true;
+                return next;
+            }
+            if (s.vi == vi && s.ti == ti && s.ni == ni) {
+                inserted = false;
+                return s.index;
+            }
+            i = (i + 1) & Mask;
+        }
+    }
+
+private:
+    struct Slot {
+        int vi = 0, ti = 0, ni = 0;
+        GLuint index = 0;
+        bool used = false;
+    };
+
+    static size_t hash(int vi, int ti, int ni)
+    {
+        uint64_t h = (uint64_t)(uint32_t)vi * 0x9E3779B97F4A7C15ull;
+        h ^= (uint64_t)(uint32_t)ti * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+        h ^= (uint64_t)(uint32_t)ni * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+        return (size_t)(h ^ (h >> 32));
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old;
+        old.swap(Slots);
+        Slots.assign(old.size() * 2, Slot());
+        Mask = Slots.size() - 1;
+        for (const Slot& s : old) {
+            if (!s.used)
+                continue;
+            size_t i = hash(s.vi, s.ti, s.ni) & Mask;
+            while (Slots[i].used)
+                i = (i + 1) & Mask;
+            Slots[i] = s;
+        }
+    }
+
+    std::vector<Slot> Slots;
+    size_t Mask = 0;
+    size_t Count = 0;
+};
+
+} // namespace
+
+bool parseMTL(const std::string& filePath, OBJMaterial& material)
+{
+    MappedFile file;
+    if (!file.open(filePath))
+        return false;
+
+    const char* p = file.data();
+    const char* end = p + file.size();
+    while (p < end) {
+        const char* lineEnd = findLineEnd(p, end);
+        const char* word = skipBlanks(p, lineEnd);
+        const char* q = word;
+        while (q < lineEnd && !isBlank(*q))
+            ++q;
+        size_t len = (size_t)(q - word);
+
+        if (keywordIs(word, len, "map_Kd")) {
+            material.mapKd = restOfLine(q, lineEnd);
+        } else if (keywordIs(word, len, "Ka")) {
+            readFloat(q, lineEnd, material.ka);
+        } else if (keywordIs(word, len, "Kd")) {
+            readFloat(q, lineEnd, material.kd);
+        } else if (keywordIs(word, len, "Ks")) {
+            readFloat(q, lineEnd, material.ks);
+        } else if (keywordIs(word, len, "Ns")) {
+            readFloat(q, lineEnd, material.ns);
+        }
+
+        p = lineEnd + 1;
+    }
+    return true;
+}
+
+namespace {
+
+struct Corner { int vi, ti, ni; };
+
+// Índices de face já em base 0: -1 = atributo ausente, >= 0 = índice absoluto.
+// Índices negativos do .obj (relativos ao último elemento lido) dependem de
+// quantos elementos os trechos anteriores têm; até a junção eles ficam
+// codificados a partir de RELATIVE_BASE como índice local ao trecho.
+const int ABSENT = -1;
+const int RELATIVE_BASE = -(1 << 30);
+
+inline int encodeIndex(int objIndex, size_t localCount)
+{
+    if (objIndex > 0)
+        return objIndex - 1;
+    if (objIndex < 0)
+        return RELATIVE_BASE + (int)localCount + objIndex;
+    return ABSENT;
+}
+
+inline int resolveIndex(int encoded, size_t chunkPrefix)
+{
+    if (encoded >= ABSENT)
+        return encoded;
+    int global = (int)chunkPrefix + (encoded - RELATIVE_BASE);
+    return global >= 0 ? global : ABSENT;
+}
+
+// Resultado de um trecho do arquivo. Cada thread escreve só no seu.
+struct ObjChunk {
+    std::vector<Vec3f> vertices;
+    std::vector<Vec2f> texCoords;
+    std::vector<Vec3f> normals;
+    std::vector<Corner> uniqueCorners; // triplas v/vt/vn distintas deste trecho
+    std::vector<GLuint> localIndices;  // índices em uniqueCorners
+    std::string mtlFile;
+};
+
+// Trechos com menos que isso não compensam uma thread
+const size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+void parseChunk(const char* p, const char* end, ObjChunk& chunk)
+{
+    size_t estimatedLines = (size_t)(end - p) / 30 + 1;
+    chunk.vertices.reserve(estimatedLines / 2);
+    chunk.localIndices.reserve(estimatedLines * 3 / 2);
+    chunk.uniqueCorners.reserve(estimatedLines / 2);
+    CornerTable corners(estimatedLines / 2);
+    std::vector<Corner> faceCorners; // reaproveitado entre as faces
+
+    while (p < end) {
+        const char* lineEnd = findLineEnd(p, end);
+        const char* q = skipBlanks(p, lineEnd);
+
+        if (q + 1 < lineEnd && q[0] == 'v' && isBlank(q[1])) {
+            Vec3f v = {0.0f, 0.0f, 0.0f};
+            q += 1;
+            readFloat(q, lineEnd, v.x);
+            readFloat(q, lineEnd, v.y);
+            readFloat(q, lineEnd, v.z);
+            chunk.vertices.push_back(v);
+        } else if (q + 2 < lineEnd && q[0] == 'v' && q[1] == 't' && isBlank(q[2])) {
+            Vec2f vt = {0.0f, 0.0f};
+            q += 2;
+            readFloat(q, lineEnd, vt.s);
+            readFloat(q, lineEnd, vt.t);
+            chunk.texCoords.push_back(vt);
+        } else if (q + 2 < lineEnd && q[0] == 'v' && q[1] == 'n' && isBlank(q[2])) {
+            Vec3f n = {0.0f, 0.0f, 0.0f};
+            q += 2;
+            readFloat(q, lineEnd, n.x);
+            readFloat(q, lineEnd, n.y);
+            readFloat(q, lineEnd, n.z);
+            chunk.normals.push_back(n);
+        } else if (q + 1 < lineEnd && q[0] == 'f' && isBlank(q[1])) {
+            q += 1;
+            faceCorners.clear();
+            int vi, ti, ni;
+            while ((q = skipBlanks(q, lineEnd)) < lineEnd && readFaceCorner(q, lineEnd, vi, ti, ni)) {
+                faceCorners.push_back(Corner{encodeIndex(vi, chunk.vertices.size()),
+                                             encodeIndex(ti, chunk.texCoords.size()),
+                                             encodeIndex(ni, chunk.normals.size())});
+            }
+
+            // Polígonos com mais de 3 vértices viram um leque de triângulos (0, k, k + 1)
+            for (size_t k = 1; k + 1 < faceCorners.size(); ++k) {
+                const Corner* triangle[3] = {&faceCorners[0], &faceCorners[k], &faceCorners[k + 1]};
+                for (const Corner* c : triangle) {
+                    bool inserted;
+                    GLuint index = corners.findOrInsert(c->vi, c->ti, c->ni, (GLuint)chunk.uniqueCorners.size(), inserted);
+                    chunk.localIndices.push_back(index);
+                    if (inserted)
+                        chunk.uniqueCorners.push_back(*c);
+                }
+            }
+        } else if (lineEnd - q > 6 && memcmp(q, "mtllib", 6) == 0 && isBlank(q[6])) {
+            chunk.mtlFile = restOfLine(q + 6, lineEnd);
+        }
+
+        p = lineEnd + 1;
+    }
+}
+
+// Concatena um atributo de todos os trechos, cada trecho copiado em paralelo
+// Retorna o deslocamento de cada trecho no vetor final.
+template <typename T>
+std::vector<size_t> mergeAttribute(ThreadPool& pool, std::vector<ObjChunk>& chunks, std::vector<T> ObjChunk::*member, std::vector<T>& out)
+{
+    std::vector<size_t> offsets(chunks.size() + 1, 0);
+    for (size_t c = 0; c < chunks.size(); ++c)
+        offsets[c + 1] = offsets[c] + (chunks[c].*member).size();
+
+    out.resize(offsets.back());
+    pool.parallelFor(chunks.size(), [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            std::vector<T>& part = chunks[c].*member;
+            std::copy(part.begin(), part.end(), out.begin() + offsets[c]);
+            std::vector<T>().swap(part);
+        }
+    });
+    return offsets;
+}
+
+Vec3f faceNormal(const GLfloat* a, const GLfloat* b, const GLfloat* c)
+{
+    // Produto vetorial sem normalizar: o comprimento é o dobro da área do
+    // triângulo, o que pondera a média das normais suaves pela área
+    float ux = b[0] - a[0], uy = b[1] - a[1], uz = b[2] - a[2];
+    float vx = c[0] - a[0], vy = c[1] - a[1], vz = c[2] - a[2];
+    return Vec3f{uy * vz - uz * vy, uz * vx - ux * vz, ux * vy - uy * vx};
+}
+
+void storeNormalized(Vec3f n, GLfloat* out)
+{
+    float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+    if (length > 1e-20f) {
+        out[0] = n.x / length;
+        out[1] = n.y / length;
+        out[2] = n.z / length;
+    } else {
+        // Triângulo degenerado ou vértice isolado
+        out[0] = 0.0f;
+        out[1] = 0.0f;
+        out[2] = 1.0f;
+    }
+}
+
+// Preenche as normais dos vértices cujo canto não tinha vn (ou tinha um vn
+// inválido). Suave: média das normais das faces que compartilham a posição.
+// Plana: cada triângulo recebe cópias próprias desses vértices com a sua normal.
+void generateNormals(ThreadPool& pool, OBJMesh& mesh, const std::vector<Corner>& uniqueCorners,
+                     const std::vector<unsigned char>& missing, size_t positionCount, bool flat)
+{
+    const size_t triangleCount = mesh.indices.size() / 3;
+    std::vector<Vec3f> faceNormals(triangleCount);
+    pool.parallelFor(triangleCount, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const GLuint* tri = &mesh.indices[t * 3];
+            faceNormals[t] = faceNormal(&mesh.vBuffer[tri[0] * OBJ_VERTEX_STRIDE],
+                                        &mesh.vBuffer[tri[1] * OBJ_VERTEX_STRIDE],
+                                        &mesh.vBuffer[tri[2] * OBJ_VERTEX_STRIDE]);
+        }
+    }, 4096);
+
+    if (flat) {
+        // Onde cada triângulo grava suas cópias (prefixo sequencial, barato)
+        std::vector<GLuint> firstCopy(triangleCount + 1, 0);
+        for (size_t t = 0; t < triangleCount; ++t) {
+            const GLuint* tri = &mesh.indices[t * 3];
+            firstCopy[t + 1] = firstCopy[t] + missing[tri[0]] + missing[tri[1]] + missing[tri[2]];
+        }
+
+        size_t base = mesh.vBuffer.size() / OBJ_VERTEX_STRIDE;
+        mesh.vBuffer.resize((base + firstCopy.back()) * OBJ_VERTEX_STRIDE);
+        pool.parallelFor(triangleCount, [&](size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t) {
+                GLuint copy = (GLuint)base + firstCopy[t];
+                for (int j = 0; j < 3; ++j) {
+                    GLuint& index = mesh.indices[t * 3 + j];
+                    if (!missing[index])
+                        continue;
+                    GLfloat* out = &mesh.vBuffer[copy * OBJ_VERTEX_STRIDE];
+                    std::copy_n(&mesh.vBuffer[index * OBJ_VERTEX_STRIDE], 5, out);
+                    storeNormalized(faceNormals[t], out + 5);
+                    index = copy++;
+                }
+            }
+        }, 4096);
+
+        // Os vértices originais sem normal deixaram de ser usados: compacta
+        std::vector<GLuint> remap(base + firstCopy.back());
+        GLuint kept = 0;
+        for (size_t k = 0; k < remap.size(); ++k) {
+            remap[k] = kept;
+            if (k >= base || !missing[k]) {
+                if (kept != k)
+                    std::copy_n(&mesh.vBuffer[k * OBJ_VERTEX_STRIDE], OBJ_VERTEX_STRIDE, &mesh.vBuffer[kept * OBJ_VERTEX_STRIDE]);
+                kept++;
+            }
+        }
+        mesh.vBuffer.resize((size_t)kept * OBJ_VERTEX_STRIDE);
+        pool.parallelFor(mesh.indices.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                mesh.indices[i] = remap[mesh.indices[i]];
+        }, 16384);
+        return;
+    }
+
+    // Triângulos adjacentes a cada posição (CSR), para somar sem disputa entre threads
+    std::vector<GLuint> adjacencyStart(positionCount + 1, 0);
+    for (GLuint index : mesh.indices) {
+        int vi = uniqueCorners[index].vi;
+        if (vi >= 0 && vi < (int)positionCount)
+            adjacencyStart[vi + 1]++;
+    }
+    for (size_t v = 0; v < positionCount; ++v)
+        adjacencyStart[v + 1] += adjacencyStart[v];
+
+    std::vector<GLuint> adjacency(adjacencyStart.back());
+    std::vector<GLuint> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+    for (size_t i = 0; i < mesh.indices.size(); ++i) {
+        int vi = uniqueCorners[mesh.indices[i]].vi;
+        if (vi >= 0 && vi < (int)positionCount)
+            adjacency[fill[vi]++] = (GLuint)(i / 3);
+    }
+    std::vector<GLuint>().swap(fill);
+
+    std::vector<GLfloat> positionNormals(positionCount * 3);
+    pool.parallelFor(positionCount, [&](size_t begin, size_t end) {
+        for (size_t v = begin; v < end; ++v) {
+            Vec3f sum{0.0f, 0.0f, 0.0f};
+            for (GLuint a = adjacencyStart[v]; a < adjacencyStart[v + 1]; ++a) {
+                const Vec3f& n = faceNormals[adjacency[a]];
+                sum.x += n.x;
+                sum.y += n.y;
+                sum.z += n.z;
+            }
+            storeNormalized(sum, &positionNormals[v * 3]);
+        }
+    }, 4096);
+
+    pool.parallelFor(uniqueCorners.size(), [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            if (!missing[k])
+                continue;
+            GLfloat* out = &mesh.vBuffer[k * OBJ_VERTEX_STRIDE + 5];
+            int vi = uniqueCorners[k].vi;
+            if (vi >= 0 && vi < (int)positionCount) {
+                std::copy_n(&positionNormals[vi * 3], 3, out);
+            } else {
+                out[0] = 0.0f;
+                out[1] = 0.0f;
+                out[2] = 1.0f;
+            }
+        }
+    }, 4096);
+}
+
+} // namespace
+
+bool parseOBJ(const std::string& filePath, OBJMesh& mesh, ThreadPool* pool, bool flatNormals)
+{
+    MappedFile file;
+    if (!file.open(filePath)) {
+        std::cerr << "Erro ao tentar ler o arquivo " << filePath << std::endl;
+        return false;
+    }
+    if (!pool)
+        pool = &ThreadPool::shared();
+
+    // Divide o arquivo em trechos terminados em '\n'; alguns por thread para equilibrar a carga
+    const char* data = file.data();
+    const char* dataEnd = data + file.size();
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(pool->concurrency() * 4, file.size() / MIN_CHUNK_BYTES));
+    std::vector<const char*> bounds(1, data);
+    for (size_t c = 1; c < chunkCount; ++c) {
+        const char* cut = data + file.size() * c / chunkCount;
+        cut = cut < bounds.back() ? bounds.back() : cut;
+        cut = findLineEnd(cut, dataEnd);
+        bounds.push_back(cut < dataEnd ? cut + 1 : dataEnd);
+    }
+    bounds.push_back(dataEnd);
+    chunkCount = bounds.size() - 1;
+
+    std::vector<ObjChunk> chunks(chunkCount);
+    pool->parallelFor(chunkCount, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c)
+            parseChunk(bounds[c], bounds[c + 1], chunks[c]);
+    });
+
+    // Índices positivos do .obj são globais: basta concatenar os atributos na ordem do arquivo
+    std::vector<Vec3f> vertices;
+    std::vector<Vec2f> texCoords;
+    std::vector<Vec3f> normals;
+    std::vector<size_t> vertexOffsets = mergeAttribute(*pool, chunks, &ObjChunk::vertices, vertices);
+    std::vector<size_t> texCoordOffsets = mergeAttribute(*pool, chunks, &ObjChunk::texCoords, texCoords);
+    std::vector<size_t> normalOffsets = mergeAttribute(*pool, chunks, &ObjChunk::normals, normals);
+
+    // Os negativos (relativos) só agora ganham seu índice absoluto
+    pool->parallelFor(chunkCount, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            for (Corner& corner : chunks[c].uniqueCorners) {
+                corner.vi = resolveIndex(corner.vi, vertexOffsets[c]);
+                corner.ti = resolveIndex(corner.ti, texCoordOffsets[c]);
+                corner.ni = resolveIndex(corner.ni, normalOffsets[c]);
+            }
+        }
+    });
+
+    // Deduplicação global: só as triplas já distintas de cada trecho passam pela
+    // tabela (sequencial, preserva a ordem de primeira ocorrência). Vale também
+    // para um trecho só: um mesmo vértice citado com índice positivo e negativo
+    // só fica igual depois de resolvido, então o resultado não depende do número de trechos
+    size_t totalUnique = 0, totalIndices = 0;
+    std::vector<size_t> indexOffsets(chunkCount + 1, 0);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        totalUnique += chunks[c].uniqueCorners.size();
+        indexOffsets[c + 1] = indexOffsets[c] + chunks[c].localIndices.size();
+    }
+    totalIndices = indexOffsets.back();
+
+    CornerTable globalTable(totalUnique);
+    std::vector<Corner> uniqueCorners;
+    std::vector<std::vector<GLuint>> remap(chunkCount);
+    uniqueCorners.reserve(totalUnique);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        remap[c].resize(chunks[c].uniqueCorners.size());
+        for (size_t k = 0; k < chunks[c].uniqueCorners.size(); ++k) {
+            const Corner& corner = chunks[c].uniqueCorners[k];
+            bool inserted;
+            remap[c][k] = globalTable.findOrInsert(corner.vi, corner.ti, corner.ni, (GLuint)uniqueCorners.size(), inserted);
+            if (inserted)
+                uniqueCorners.push_back(corner);
+        }
+    }
+
+    mesh.indices.resize(totalIndices);
+    pool->parallelFor(chunkCount, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c) {
+            const std::vector<GLuint>& local = chunks[c].localIndices;
+            GLuint* out = mesh.indices.data() + indexOffsets[c];
+            for (size_t j = 0; j < local.size(); ++j)
+                out[j] = remap[c][local[j]];
+        }
+    });
+
+    mesh.vBuffer.assign(uniqueCorners.size() * OBJ_VERTEX_STRIDE, 0.0f);
+    pool->parallelFor(uniqueCorners.size(), [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            const Corner& c = uniqueCorners[k];
+            GLfloat* out = &mesh.vBuffer[k * OBJ_VERTEX_STRIDE];
+
+            if (c.vi >= 0 && c.vi < (int)vertices.size()) {
+                out[0] = vertices[c.vi].x;
+                out[1] = vertices[c.vi].y;
+                out[2] = vertices[c.vi].z;
+            }
+            if (c.ti >= 0 && c.ti < (int)texCoords.size()) {
+                out[3] = texCoords[c.ti].s;
+                out[4] = texCoords[c.ti].t;
+            }
+            if (c.ni >= 0 && c.ni < (int)normals.size()) {
+                out[5] = normals[c.ni].x;
+                out[6] = normals[c.ni].y;
+                out[7] = normals[c.ni].z;
+            }
+        }
+    }, 4096);
+
+    // Cantos sem vn (v, v/vt ou índice de normal fora do arquivo) recebem normais calculadas
+    std::vector<unsigned char> missingNormal(uniqueCorners.size());
+    size_t missingCount = 0;
+    for (size_t k = 0; k < uniqueCorners.size(); ++k) {
+        int ni = uniqueCorners[k].ni;
+        missingNormal[k] = ni < 0 || ni >= (int)normals.size();
+        missingCount += missingNormal[k];
+    }
+    if (missingCount > 0)
+        generateNormals(*pool, mesh, uniqueCorners, missingNormal, vertices.size(), flatNormals);
+
+    mesh.mtlFile.clear();
+    for (const ObjChunk& chunk : chunks) {
+        if (!chunk.mtlFile.empty())
+            mesh.mtlFile = chunk.mtlFile;
+    }
+
+    mesh.nVertices = (int)(mesh.vBuffer.size() / OBJ_VERTEX_STRIDE);
+    mesh.nIndices = (int)mesh.indices.size();
+    mesh.bounds = computeBounds(mesh.vBuffer.data(), (size_t)mesh.nVertices, OBJ_VERTEX_STRIDE);
+
+    if (!mesh.mtlFile.empty())
+        mesh.hasMaterial = parseMTL(mesh.mtlFile, mesh.material);
+
+    return true;
+}
+
+GLMesh uploadMesh(const void* vertexData, size_t vertexBytes, const void* indexData, size_t indexBytes,
+                  GLenum indexType, GLsizei nIndices)
+{
+    GLMesh glMesh;
+    glMesh.nIndices = nIndices;
+    glMesh.indexType = indexType;
+    glMesh.bounds = computeBounds((const GLfloat*)vertexData, vertexBytes / (OBJ_VERTEX_STRIDE * sizeof(GLfloat)), OBJ_VERTEX_STRIDE);
+
+    glGenVertexArrays(1, &glMesh.VAO);
+    glBindVertexArray(glMesh.VAO);
+
+    glGenBuffers(1, &glMesh.VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, glMesh.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexBytes, vertexData, GL_STATIC_DRAW);
+
+    // O EBO fica registrado no VAO enquanto ele estiver vinculado
+    glGenBuffers(1, &glMesh.EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glMesh.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indexData, GL_STATIC_DRAW);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)0);
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(1);
+
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)(5 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    return glMesh;
+}
+
+GLMesh uploadOBJ(const OBJMesh& mesh)
+{
+    size_t vertexBytes = mesh.vBuffer.size() * sizeof(GLfloat);
+    if (mesh.nVertices <= 0xFFFF) {
+        std::vector<GLushort> shortIndices(mesh.indices.begin(), mesh.indices.end());
+        return uploadMesh(mesh.vBuffer.data(), vertexBytes, shortIndices.data(), shortIndices.size() * sizeof(GLushort),
+                          GL_UNSIGNED_SHORT, mesh.nIndices);
+    }
+    return uploadMesh(mesh.vBuffer.data(), vertexBytes, mesh.indices.data(), mesh.indices.size() * sizeof(GLuint),
+                      GL_UNSIGNED_INT, mesh.nIndices);
+}
+
+bool loadOBJ(const std::string& filePath, GLMesh& glMesh, OBJMaterial* material)
+{
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start = Clock::now();
+
+    if (loadMeshCache(filePath, glMesh, material))
+        return true;
+
+    OBJMesh mesh;
+    if (!parseOBJ(filePath, mesh))
+        return false;
+
+    if (material && mesh.hasMaterial)
+        *material = mesh.material;
+
+    glMesh = uploadOBJ(mesh);
+    std::cout << "Malha " << filePath << " lida do .obj em "
+              << std::chrono::duration<double, std::milli>(Clock::now() - start).count() << " ms" << std::endl;
+
+    // Na próxima execução a malha vem direto do arquivo binário
+    writeMeshCache(filePath, mesh);
+    return true;
+}
+
+void drawMesh(const GLMesh& glMesh)
+{
+    glBindVertexArray(glMesh.VAO);
+    glDrawElements(GL_TRIANGLES, glMesh.nIndices, glMesh.indexType, (GLvoid *)0);
+}
+
+void drawMeshInstanced(const GLMesh& glMesh, GLsizei instanceCount)
+{
+    glBindVertexArray(glMesh.VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, glMesh.nIndices, glMesh.indexType, (GLvoid *)0, instanceCount);
+}
+
+void deleteMesh(GLMesh& glMesh)
+{
+    glDeleteVertexArrays(1, &glMesh.VAO);
+    glDeleteBuffers(1, &glMesh.VBO);
+    glDeleteBuffers(1, &glMesh.EBO);
+    glMesh = GLMesh();
+}
+
+int loadSimpleOBJ(const std::string& filePath, int& nVertices, OBJMaterial* material)
+{
+    OBJMesh mesh;
+    if (!parseOBJ(filePath, mesh))
+        return -1;
+
+    if (material && mesh.hasMaterial)
+        *material = mesh.material;
+
+    // Expande os índices de volta para um vértice por canto de face
+    std::vector<GLfloat> vBuffer(mesh.indices.size() * OBJ_VERTEX_STRIDE);
+    for (size_t i = 0; i < mesh.indices.size(); ++i)
+        memcpy(&vBuffer[i * OBJ_VERTEX_STRIDE], &mesh.vBuffer[mesh.indices[i] * OBJ_VERTEX_STRIDE], OBJ_VERTEX_STRIDE * sizeof(GLfloat));
+
+    GLuint VBO, VAO;
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, vBuffer.size() * sizeof(GLfloat), vBuffer.data(), GL_STATIC_DRAW);
+
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
+
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)0);
+    glEnableVertexAttribArray(0);
+
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(1);
+
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, OBJ_VERTEX_STRIDE * sizeof(GLfloat), (GLvoid *)(5 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(2);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+
+    nVertices = mesh.nIndices;
+    return VAO;
+}
@@ -0,0 +1,195 @@
+#include "PathAgents.h"
+#include "SplinePath.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Blocos grandes: o trabalho por agente é pequeno demais para dividir mais fino
+const size_t MIN_AGENTS_PER_BLOCK = 16384;
+
+} // namespace
+
+void PathAgents::setPath(const SplinePath* path)
+{
+    clear();
+    Path = path;
+}
+
+void PathAgents::reserve(size_t count)
+{
+    for (std::vector<float>* v : {&Offset, &Length, &C0, &C1, &C2, &C3, &Speed, &PosX, &PosY, &PosZ, &PrevX, &PrevY, &PrevZ})
+        v->reserve(count);
+    Interval.reserve(count);
+}
+
+void PathAgents::clear()
+{
+    for (std::vector<float>* v : {&Offset, &Length, &C0, &C1, &C2, &C3, &Speed, &PosX, &PosY, &PosZ, &PrevX, &PrevY, &PrevZ})
+        v->clear();
+    Interval.clear();
+}
+
+size_t PathAgents::add(double distance, float speed)
+{
+    size_t interval = 0;
+    float offset = 0.0f;
+    if (Path && !Path->empty())
+        Path->locateInterval(distance, interval, offset);
+
+    size_t i = size();
+    Interval.push_back((uint32_t)interval);
+    Offset.push_back(offset);
+    Speed.push_back(std::max(speed, 0.0f));
+    for (std::vector<float>* v : {&Length, &C0, &C1, &C2, &C3, &PosX, &PosY, &PosZ, &PrevX, &PrevY, &PrevZ})
+        v->push_back(0.0f);
+
+    if (Path && !Path->empty()) {
+        float c[4];
+        Path->intervalInverse(interval, c);
+        Length[i] = Path->intervalLength(interval);
+        C0[i] = c[0]; C1[i] = c[1]; C2[i] = c[2]; C3[i] = c[3];
+        evaluate(i);
+        PrevX[i] = PosX[i]; PrevY[i] = PosY[i]; PrevZ[i] = PosZ[i];
+    }
+    return i;
+}
+
+void PathAgents::setSpeed(size_t i, float speed)
+{
+    Speed[i] = std::max(speed, 0.0f);
+}
+
+double PathAgents::distance(size_t i) const
+{
+    return Path && !Path->empty() ? Path->intervalStart(Interval[i]) + Offset[i] : 0.0;
+}
+
+void PathAgents::nextInterval(size_t i)
+{
+    size_t count = Path->intervalCount();
+    size_t interval = Interval[i];
+    float offset = Offset[i];
+    // Passos maiores que um trecho (velocidade alta, trechos curtos) atravessam vários
+    for (size_t guard = 0; offset >= Length[i] && guard < count; ++guard) {
+        if (interval + 1 == count && !Path->closed()) {
+            offset = Length[i];
+            break;
+        }
+        offset -= Length[i];
+        interval = (interval + 1) % count;
+        Length[i] = Path->intervalLength(interval);
+    }
+
+    float c[4];
+    Path->intervalInverse(interval, c);
+    Interval[i] = (uint32_t)interval;
+    Offset[i] = std::min(offset, Length[i]);
+    C0[i] = c[0]; C1[i] = c[1]; C2[i] = c[2]; C3[i] = c[3];
+}
+
+void PathAgents::evaluate(size_t i)
+{
+    float u = Offset[i];
+    float t = ((C3[i] * u + C2[i]) * u + C1[i]) * u + C0[i];
+    glm::vec3 p = Path->segmentPoint(Interval[i] / Path->samplesPerSegment(), t);
+    PosX[i] = p.x; PosY[i] = p.y; PosZ[i] = p.z;
+}
+
+void PathAgents::updateRange(size_t begin, size_t end, float dt)
+{
+    // Posições do passo anterior, para interpolar no desenho
+    std::copy(PosX.begin() + begin, PosX.begin() + end, PrevX.begin() + begin);
+    std::copy(PosY.begin() + begin, PosY.begin() + end, PrevY.begin() + begin);
+    std::copy(PosZ.begin() + begin, PosZ.begin() + end, PrevZ.begin() + begin);
+
+    size_t i = begin;
+#ifdef __SSE2__
+    const int samples = Path->samplesPerSegment();
+    const __m128 step = _mm_set1_ps(dt);
+    for (; i + 4 <= end; i += 4) {
+        __m128 offset = _mm_add_ps(_mm_loadu_ps(&Offset[i]), _mm_mul_ps(_mm_loadu_ps(&Speed[i]), step));
+        _mm_storeu_ps(&Offset[i], offset);
+        int crossed = _mm_movemask_ps(_mm_cmpge_ps(offset, _mm_loadu_ps(&Length[i])));
+        if (crossed) {
+            for (int lane = 0; lane < 4; ++lane)
+                if (crossed & (1 << lane))
+                    nextInterval(i + lane);
+            offset = _mm_loadu_ps(&Offset[i]);
+        }
+
+        __m128 t = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&C3[i]), offset), _mm_loadu_ps(&C2[i]));
+        t = _mm_add_ps(_mm_mul_ps(t, offset), _mm_loadu_ps(&C1[i]));
+        t = _mm_add_ps(_mm_mul_ps(t, offset), _mm_loadu_ps(&C0[i]));
+
+        // Coeficientes dos segmentos dos 4 agentes, transpostos para um vetor por componente:
+        // r0 = ax ay az bx, r1 = by bz cx cy, r2 = cz dx dy dz
+        __m128 r0[4], r1[4], r2[4];
+        for (int lane = 0; lane < 4; ++lane) {
+            const float* c = Path->segmentCoefficients(Interval[i + lane] / samples);
+            r0[lane] = _mm_loadu_ps(c);
+            r1[lane] = _mm_loadu_ps(c + 4);
+            r2[lane] = _mm_loadu_ps(c + 8);
+        }
+        _MM_TRANSPOSE4_PS(r0[0], r0[1], r0[2], r0[3]);
+        _MM_TRANSPOSE4_PS(r1[0], r1[1], r1[2], r1[3]);
+        _MM_TRANSPOSE4_PS(r2[0], r2[1], r2[2], r2[3]);
+        const __m128 a[3] = {r0[0], r0[1], r0[2]};
+        const __m128 b[3] = {r0[3], r1[0], r1[1]};
+        const __m128 c[3] = {r1[2], r1[3], r2[0]};
+        const __m128 d[3] = {r2[1], r2[2], r2[3]};
+        float* out[3] = {&PosX[i], &PosY[i], &PosZ[i]};
+        for (int k = 0; k < 3; ++k) {
+            __m128 p = _mm_add_ps(_mm_mul_ps(a[k], t), b[k]);
+            p = _mm_add_ps(_mm_mul_ps(p, t), c[k]);
+            p = _mm_add_ps(_mm_mul_ps(p, t), d[k]);
+            _mm_storeu_ps(out[k], p);
+        }
+    }
+#endif
+    for (; i < end; ++i) {
+        Offset[i] += Speed[i] * dt;
+        if (Offset[i] >= Length[i])
+            nextInterval(i);
+        evaluate(i);
+    }
+}
+
+void PathAgents::update(float dt, ThreadPool* pool)
+{
+    if (!Path || Path->empty() || size() == 0)
+        return;
+    if (!pool) {
+        updateRange(0, size(), dt);
+        return;
+    }
+    pool->parallelFor(size(), [&](size_t begin, size_t end) {
+        updateRange(begin, end, dt);
+    }, MIN_AGENTS_PER_BLOCK);
+}
+
+void PathAgents::writeInstances(InstanceData* out, float scale, const glm::vec3& color, ThreadPool* pool,
+                                float alpha) const
+{
+    InstanceData base;
+    base.model = glm::mat4(scale);
+    base.model[3][3] = 1.0f;
+    base.color = color;
+    auto write = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            InstanceData instance = base;
+            instance.model[3] = glm::vec4(PrevX[i] + (PosX[i] - PrevX[i]) * alpha, PrevY[i] + (PosY[i] - PrevY[i]) * alpha,
+                                          PrevZ[i] + (PosZ[i] - PrevZ[i]) * alpha, 1.0f);
+            out[i] = instance;
+        }
+    };
+    if (pool)
+        pool->parallelFor(size(), write, MIN_AGENTS_PER_BLOCK);
+    else
+        write(0, size());
+}
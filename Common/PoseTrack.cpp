@@ -0,0 +1,245 @@
+#include "PoseTrack.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace {
+
+const char POSE_MAGIC[8] = {'P', 'O', 'S', 'E', 'T', 'R', 'K', '\0'};
+const uint32_t POSE_VERSION = 1;
+
+struct PoseFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t trackCount;
+};
+
+// Ângulo da rotação que leva a até b (radianos)
+float angleBetween(const glm::quat& a, const glm::quat& b)
+{
+    float d = std::min(std::fabs(glm::dot(a, b)), 1.0f);
+    return 2.0f * std::acos(d);
+}
+
+} // namespace
+
+void PoseTrack::clear()
+{
+    Times.clear();
+    Positions.clear();
+    Orientations.clear();
+}
+
+void PoseTrack::addKey(double time, const Pose& pose)
+{
+    if (!Times.empty() && time < Times.back())
+        return;
+    // Mesmo hemisfério do quadro anterior: o slerp vai pelo caminho curto
+    glm::quat orientation = pose.orientation;
+    if (!Orientations.empty() && glm::dot(Orientations.back(), orientation) < 0.0f)
+        orientation = -orientation;
+    Times.push_back(time);
+    Positions.push_back(pose.position);
+    Orientations.push_back(orientation);
+}
+
+Pose PoseTrack::interpolate(size_t i, double time) const
+{
+    if (i + 1 >= Times.size() || time <= Times[i])
+        return key(i);
+    double span = Times[i + 1] - Times[i];
+    float u = span > 0.0 ? (float)std::min((time - Times[i]) / span, 1.0) : 0.0f;
+    Pose pose;
+    pose.position = glm::mix(Positions[i], Positions[i + 1], u);
+    pose.orientation = glm::slerp(Orientations[i], Orientations[i + 1], u);
+    return pose;
+}
+
+Pose PoseTrack::sample(double time) const
+{
+    size_t cursor = 0;
+    return sample(time, cursor);
+}
+
+Pose PoseTrack::sample(double time, size_t& cursor) const
+{
+    if (Times.empty())
+        return Pose();
+    // Reprodução em ordem: o quadro é o mesmo ou o seguinte
+    for (size_t i = cursor; i < cursor + 2 && i + 1 < Times.size(); ++i) {
+        if (Times[i] <= time && time < Times[i + 1]) {
+            cursor = i;
+            return interpolate(i, time);
+        }
+    }
+    size_t after = std::upper_bound(Times.begin(), Times.end(), time) - Times.begin();
+    cursor = after > 0 ? after - 1 : 0;
+    return interpolate(cursor, time);
+}
+
+void PoseRecorder::start(double rate, float positionTolerance, float angleTolerance, size_t window)
+{
+    Track.clear();
+    RawTimes.clear();
+    Raw.clear();
+    Period = 1.0 / (rate > 0.0 ? rate : 60.0);
+    NextSample = -1e300;
+    PositionTolerance = std::max(positionTolerance, 1e-6f);
+    AngleTolerance = std::max(glm::radians(angleTolerance), 1e-6f);
+    Window = std::max<size_t>(window, 3);
+    Samples = 0;
+}
+
+void PoseRecorder::sample(double time, const Pose& pose)
+{
+    // Folga mínima: passos de exatamente 1/rate não pulam amostras por arredondamento
+    if (time < NextSample - 1e-6 * Period)
+        return;
+    NextSample += Period;
+    if (NextSample <= time)
+        NextSample = time + Period;
+    RawTimes.push_back(time);
+    Raw.push_back(pose);
+    Samples++;
+    if (Raw.size() >= Window)
+        reduce(false);
+}
+
+void PoseRecorder::reduce(bool last)
+{
+    size_t n = Raw.size();
+    if (n == 0)
+        return;
+    std::vector<char> keep(n, 0);
+    keep[0] = keep[n - 1] = 1;
+
+    // Ramer-Douglas-Peucker com pilha explícita (janelas longas não estouram a recursão)
+    std::vector<std::pair<size_t, size_t>> ranges;
+    if (n > 2)
+        ranges.push_back({0, n - 1});
+    while (!ranges.empty()) {
+        size_t a = ranges.back().first, b = ranges.back().second;
+        ranges.pop_back();
+        double span = RawTimes[b] - RawTimes[a];
+        float worst = 1.0f;
+        size_t split = 0;
+        for (size_t k = a + 1; k < b; ++k) {
+            float u = span > 0.0 ? (float)((RawTimes[k] - RawTimes[a]) / span) : 0.0f;
+            glm::vec3 position = glm::mix(Raw[a].position, Raw[b].position, u);
+            glm::quat orientation = glm::slerp(Raw[a].orientation, Raw[b].orientation, u);
+            // Erro relativo à tolerância: acima de 1, a amostra precisa virar quadro-chave
+            float error = std::max(glm::length(Raw[k].position - position) / PositionTolerance,
+                                   angleBetween(Raw[k].orientation, orientation) / AngleTolerance);
+            if (error > worst) {
+                worst = error;
+                split = k;
+            }
+        }
+        if (split) {
+            keep[split] = 1;
+            if (split - a > 1)
+                ranges.push_back({a, split});
+            if (b - split > 1)
+                ranges.push_back({split, b});
+        }
+    }
+
+    for (size_t k = 0; k + 1 < n; ++k)
+        if (keep[k])
+            Track.addKey(RawTimes[k], Raw[k]);
+    if (last) {
+        Track.addKey(RawTimes[n - 1], Raw[n - 1]);
+        RawTimes.clear();
+        Raw.clear();
+    } else {
+        // A última amostra é o primeiro quadro da próxima janela
+        RawTimes.assign(1, RawTimes[n - 1]);
+        Raw.assign(1, Raw[n - 1]);
+    }
+}
+
+const PoseTrack& PoseRecorder::finish()
+{
+    reduce(true);
+    return Track;
+}
+
+bool savePoseTracks(const std::string& filePath, const std::vector<PoseTrack>& tracks)
+{
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    PoseFileHeader header = {};
+    memcpy(header.magic, POSE_MAGIC, sizeof(POSE_MAGIC));
+    header.version = POSE_VERSION;
+    header.trackCount = (uint32_t)tracks.size();
+    file.write((const char*)&header, sizeof(header));
+
+    // Por trilha: número de quadros e, em arrays, tempos, posições e orientações (x y z w)
+    for (const PoseTrack& track : tracks) {
+        uint64_t count = track.size();
+        file.write((const char*)&count, sizeof(count));
+        for (size_t i = 0; i < track.size(); ++i) {
+            double time = track.time(i);
+            file.write((const char*)&time, sizeof(time));
+        }
+        for (size_t i = 0; i < track.size(); ++i) {
+            glm::vec3 p = track.key(i).position;
+            float values[3] = {p.x, p.y, p.z};
+            file.write((const char*)values, sizeof(values));
+        }
+        for (size_t i = 0; i < track.size(); ++i) {
+            glm::quat q = track.key(i).orientation;
+            float values[4] = {q.x, q.y, q.z, q.w};
+            file.write((const char*)values, sizeof(values));
+        }
+    }
+    return (bool)file;
+}
+
+bool loadPoseTracks(const std::string& filePath, std::vector<PoseTrack>& tracks)
+{
+    MappedFile file;
+    if (!file.open(filePath) || file.size() < sizeof(PoseFileHeader))
+        return false;
+    PoseFileHeader header;
+    memcpy(&header, file.data(), sizeof(header));
+    if (memcmp(header.magic, POSE_MAGIC, sizeof(POSE_MAGIC)) != 0 || header.version != POSE_VERSION)
+        return false;
+
+    tracks.assign(header.trackCount, PoseTrack());
+    size_t offset = sizeof(header);
+    for (PoseTrack& track : tracks) {
+        uint64_t count;
+        if (offset + sizeof(count) > file.size())
+            return false;
+        memcpy(&count, file.data() + offset, sizeof(count));
+        offset += sizeof(count);
+        const size_t keyBytes = sizeof(double) + 7 * sizeof(float);
+        if (count > (file.size() - offset) / keyBytes)
+            return false;
+
+        const char* times = file.data() + offset;
+        const char* positions = times + count * sizeof(double);
+        const char* orientations = positions + count * 3 * sizeof(float);
+        for (size_t i = 0; i < count; ++i) {
+            double time;
+            float p[3], q[4];
+            memcpy(&time, times + i * sizeof(time), sizeof(time));
+            memcpy(p, positions + i * sizeof(p), sizeof(p));
+            memcpy(q, orientations + i * sizeof(q), sizeof(q));
+            Pose pose;
+            pose.position = glm::vec3(p[0], p[1], p[2]);
+            pose.orientation = glm::quat(q[3], q[0], q[1], q[2]);
+            track.addKey(time, pose);
+        }
+        offset += count * keyBytes;
+    }
+    return true;
+}
@@ -0,0 +1,305 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const size_t RING_EVENTS = 1 << 14;      // por thread
+const size_t HISTORY_FRAMES = 300;       // quadros considerados em printStats
+const size_t MAX_TRACE_EVENTS = 1 << 20; // depois disso o trace para de crescer
+
+std::atomic<bool> profilerEnabled(false);
+const std::chrono::steady_clock::time_point programStart = std::chrono::steady_clock::now();
+
+void stats(const std::vector<float>& history, float& minimum, float& average, float& p99)
+{
+    std::vector<float> sorted(history);
+    std::sort(sorted.begin(), sorted.end());
+    minimum = sorted.front();
+    double sum = 0.0;
+    for (float value : sorted)
+        sum += value;
+    average = (float)(sum / sorted.size());
+    size_t rank = (size_t)std::ceil(0.99 * sorted.size());
+    p99 = sorted[rank > 0 ? rank - 1 : 0];
+}
+
+void writeJsonString(std::ofstream& file, const char* text)
+{
+    file << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\')
+            file << '\\';
+        file << *c;
+    }
+    file << '"';
+}
+
+} // namespace
+
+// Anel de uma thread: só ela escreve (recordCpu) e só a thread da OpenGL lê
+// (endFrame). Written é publicado depois do evento, então o leitor nunca vê
+// um evento pela metade, a não ser que fique mais de meio anel atrasado.
+struct Profiler::ThreadEvents {
+    uint32_t thread = 0;
+    std::vector<TraceEvent> ring = std::vector<TraceEvent>(RING_EVENTS);
+    std::atomic<uint64_t> written{0};
+    uint64_t read = 0;
+};
+
+Profiler& Profiler::shared()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    profilerEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::enabled() const
+{
+    return profilerEnabled.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::now()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - programStart).count();
+}
+
+void Profiler::recordCpu(const char* name, uint64_t start, uint64_t end)
+{
+    thread_local std::shared_ptr<ThreadEvents> local;
+    if (!local) {
+        local = std::make_shared<ThreadEvents>();
+        Profiler& profiler = shared();
+        std::lock_guard<std::mutex> lock(profiler.ThreadsMutex);
+        local->thread = (uint32_t)profiler.Threads.size() + 1; // 0 é a GPU
+        profiler.Threads.push_back(local);
+    }
+
+    uint64_t index = local->written.load(std::memory_order_relaxed);
+    TraceEvent& event = local->ring[index % RING_EVENTS];
+    event.name = name;
+    event.thread = local->thread;
+    event.start = start;
+    event.duration = end - start;
+    local->written.store(index + 1, std::memory_order_release);
+}
+
+void Profiler::pushSample(std::vector<float>& history, size_t& next, float value)
+{
+    if (history.size() < HISTORY_FRAMES) {
+        history.push_back(value);
+    } else {
+        history[next] = value;
+        next = (next + 1) % HISTORY_FRAMES;
+    }
+}
+
+void Profiler::pushTrace(const TraceEvent& event)
+{
+    if (Trace.size() < MAX_TRACE_EVENTS)
+        Trace.push_back(event);
+    else
+        DroppedEvents++;
+}
+
+void Profiler::beginFrame()
+{
+    if (!enabled())
+        return;
+    FrameStart = now();
+    CurrentGpuFrame = (int)(Frames & 1);
+    // As consultas deste buffer são de dois quadros atrás: já devem estar prontas
+    harvestGpu(GpuFrames[CurrentGpuFrame]);
+}
+
+void Profiler::endFrame()
+{
+    if (!enabled())
+        return;
+    recordCpu("quadro", FrameStart, now());
+
+    std::vector<std::shared_ptr<ThreadEvents>> threads;
+    {
+        std::lock_guard<std::mutex> lock(ThreadsMutex);
+        threads = Threads;
+    }
+
+    // Soma das zonas de mesmo nome no quadro (uma zona pode repetir)
+    std::map<std::string, double> frameMs;
+    for (const std::shared_ptr<ThreadEvents>& events : threads) {
+        uint64_t written = events->written.load(std::memory_order_acquire);
+        if (written - events->read > RING_EVENTS / 2) {
+            DroppedEvents += written - events->read - RING_EVENTS / 2;
+            events->read = written - RING_EVENTS / 2;
+        }
+        for (; events->read < written; ++events->read) {
+            const TraceEvent& event = events->ring[events->read % RING_EVENTS];
+            frameMs[event.name] += event.duration * 1e-6;
+            pushTrace(event);
+        }
+    }
+    for (const auto& zone : frameMs) {
+        ZoneStats& zoneStats = Zones[zone.first];
+        pushSample(zoneStats.cpuMs, zoneStats.cpuNext, (float)zone.second);
+    }
+    Frames++;
+}
+
+bool Profiler::beginGpu(const char* name)
+{
+    if (!enabled() || GpuOpen)
+        return false;
+    GpuFrame& frame = GpuFrames[CurrentGpuFrame];
+    if (frame.used == frame.queries.size()) {
+        GpuQuery query;
+        glGenQueries(1, &query.query);
+        frame.queries.push_back(query);
+    }
+    GpuQuery& query = frame.queries[frame.used++];
+    query.name = name;
+    query.cpuStart = now();
+    glBeginQuery(GL_TIME_ELAPSED, query.query);
+    GpuOpen = true;
+    return true;
+}
+
+void Profiler::endGpu()
+{
+    if (!GpuOpen)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    GpuOpen = false;
+}
+
+void Profiler::harvestGpu(GpuFrame& frame)
+{
+    std::map<std::string, double> frameMs;
+    for (size_t i = 0; i < frame.used; ++i) {
+        GpuQuery& query = frame.queries[i];
+        GLint available = 0;
+        glGetQueryObjectiv(query.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            // GPU mais de dois quadros atrás: descarta em vez de esperar
+            DroppedEvents += frame.used - i;
+            break;
+        }
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(query.query, GL_QUERY_RESULT, &elapsed);
+        frameMs[query.name] += elapsed * 1e-6;
+
+        // O início na GPU não é conhecido: o evento fica no instante em que foi emitido
+        TraceEvent event;
+        event.name = query.name;
+        event.thread = 0;
+        event.start = query.cpuStart;
+        event.duration = elapsed;
+        pushTrace(event);
+    }
+    for (const auto& zone : frameMs) {
+        ZoneStats& zoneStats = Zones[zone.first];
+        pushSample(zoneStats.gpuMs, zoneStats.gpuNext, (float)zone.second);
+    }
+    frame.used = 0;
+}
+
+void Profiler::printStats(std::ostream& out) const
+{
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << "Perfil (" << std::min<uint64_t>(Frames, HISTORY_FRAMES) << " quadros, ms min/méd/p99)" << std::endl;
+    for (const auto& zone : Zones) {
+        float minimum, average, p99;
+        out << "  " << std::left << std::setw(12) << zone.first << std::right;
+        if (!zone.second.cpuMs.empty()) {
+            stats(zone.second.cpuMs, minimum, average, p99);
+            out << " CPU " << minimum << " / " << average << " / " << p99;
+        }
+        if (!zone.second.gpuMs.empty()) {
+            stats(zone.second.gpuMs, minimum, average, p99);
+            out << " GPU " << minimum << " / " << average << " / " << p99;
+        }
+        out << std::endl;
+    }
+    if (DroppedEvents > 0)
+        out << "  (" << DroppedEvents << " eventos perdidos)" << std::endl;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+bool Profiler::writeChromeTrace(const std::string& filePath) const
+{
+    std::ofstream file(filePath, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Falha ao gravar o trace: " << filePath << std::endl;
+        return false;
+    }
+
+    size_t threadCount;
+    {
+        std::lock_guard<std::mutex> lock(ThreadsMutex);
+        threadCount = Threads.size();
+    }
+
+    // Tempos em microssegundos, "X" = evento completo (início + duração)
+    file << "{\"traceEvents\":[\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+    for (size_t t = 1; t <= threadCount; ++t)
+        file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+             << ",\"args\":{\"name\":\"CPU " << t << "\"}}";
+    char timing[64];
+    for (const TraceEvent& event : Trace) {
+        file << ",\n{\"name\":";
+        writeJsonString(file, event.name);
+        snprintf(timing, sizeof(timing), "%.3f,\"dur\":%.3f", event.start * 1e-3, event.duration * 1e-3);
+        file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":" << timing << "}";
+    }
+    file << "\n]}\n";
+    return (bool)file;
+}
+
+void Profiler::release()
+{
+    if (GpuOpen)
+        endGpu();
+    for (GpuFrame& frame : GpuFrames) {
+        for (GpuQuery& query : frame.queries)
+            glDeleteQueries(1, &query.query);
+        frame.queries.clear();
+        frame.used = 0;
+    }
+}
+
+ProfileScope::ProfileScope(const char* name)
+    : Name(name), Start(profilerEnabled.load(std::memory_order_relaxed) ? Profiler::now() : 0)
+{
+}
+
+ProfileScope::~ProfileScope()
+{
+    if (Start != 0)
+        Profiler::recordCpu(Name, Start, Profiler::now());
+}
+
+GpuProfileScope::GpuProfileScope(const char* name)
+    : Active(Profiler::shared().beginGpu(name))
+{
+}
+
+GpuProfileScope::~GpuProfileScope()
+{
+    if (Active)
+        Profiler::shared().endGpu();
+}
@@ -0,0 +1,179 @@
+#include "ShaderCache.h"
+#include "GLExtras.h"
+#include "MeshCache.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint32_t SHADER_CACHE_MAGIC = 0x52444853; // "SHDR"
+const uint32_t SHADER_CACHE_VERSION = 1;
+
+struct ShaderCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t driverHash;
+    uint32_t binaryFormat;
+    uint32_t binaryLength;
+};
+
+uint64_t hashString(const std::string& str)
+{
+    return hashBytes(str.data(), str.size());
+}
+
+std::string glString(GLenum name)
+{
+    const GLubyte* str = glGetString(name);
+    return str ? (const char*)str : "";
+}
+
+bool binariesSupported()
+{
+    if (!glGetProgramBinary || !glProgramBinary || !glProgramParameteri)
+        return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+GLuint compileShader(GLenum type, const GLchar* source, const char* label)
+{
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+    GLint success;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        GLchar infoLog[512];
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::" << label << "::COMPILATION_FAILED\n" << infoLog << std::endl;
+    }
+    return shader;
+}
+
+bool restoreProgram(const std::string& path, uint64_t sourceHash, uint64_t driverHash, GLuint& program)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    ShaderCacheHeader header;
+    if (!file.read((char*)&header, sizeof(header)) || header.magic != SHADER_CACHE_MAGIC ||
+        header.version != SHADER_CACHE_VERSION || header.sourceHash != sourceHash || header.driverHash != driverHash)
+        return false;
+
+    std::vector<char> binary(header.binaryLength);
+    if (!file.read(binary.data(), (std::streamsize)binary.size()))
+        return false;
+
+    program = glCreateProgram();
+    glProgramBinary(program, header.binaryFormat, binary.data(), (GLsizei)binary.size());
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        // Driver atualizado sem mudar a string de versão, por exemplo
+        glDeleteProgram(program);
+        program = 0;
+        return false;
+    }
+    return true;
+}
+
+void storeProgram(const std::string& path, uint64_t sourceHash, uint64_t driverHash, GLuint program)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    ShaderCacheHeader header = {};
+    header.magic = SHADER_CACHE_MAGIC;
+    header.version = SHADER_CACHE_VERSION;
+    header.sourceHash = sourceHash;
+    header.driverHash = driverHash;
+    std::vector<char> binary((size_t)length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return;
+    header.binaryFormat = format;
+    header.binaryLength = (uint32_t)written;
+
+    std::error_code ec;
+    fs::create_directories(SHADER_CACHE_DIR, ec);
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return;
+        file.write((const char*)&header, sizeof(header));
+        file.write(binary.data(), written);
+        if (!file)
+            return;
+    }
+    fs::rename(tmpPath, path, ec);
+    if (ec)
+        fs::remove(tmpPath, ec);
+}
+
+} // namespace
+
+GLuint createShaderProgram(const GLchar* vertexSource, const GLchar* fragmentSource)
+{
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point t0 = Clock::now();
+
+    bool cacheable = binariesSupported();
+    uint64_t sourceHash = hashString(std::string(vertexSource) + '\0' + fragmentSource);
+    uint64_t driverHash = hashString(glString(GL_VENDOR) + '\0' + glString(GL_RENDERER) + '\0' + glString(GL_VERSION));
+    char name[40];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)(sourceHash ^ (driverHash * 0x9E3779B97F4A7C15ull)));
+    std::string path = (fs::path(SHADER_CACHE_DIR) / name).string();
+
+    GLuint program = 0;
+    if (cacheable && restoreProgram(path, sourceHash, driverHash, program)) {
+        std::cout << "Shader restaurado do cache em "
+                  << std::chrono::duration<double, std::milli>(Clock::now() - t0).count() << " ms" << std::endl;
+        return program;
+    }
+
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource, "VERTEX");
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource, "FRAGMENT");
+
+    program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    if (cacheable)
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(program);
+
+    GLint success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        GLchar infoLog[512];
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+    }
+
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    std::cout << "Shader compilado em " << std::chrono::duration<double, std::milli>(Clock::now() - t0).count()
+              << " ms" << std::endl;
+
+    if (success && cacheable)
+        storeProgram(path, sourceHash, driverHash, program);
+    return program;
+}
@@ -0,0 +1,66 @@
+#include "ShaderProgram.h"
+
+#include <algorithm>
+
+ShaderProgram::ShaderProgram(GLuint program)
+    : Program(program)
+{
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<GLchar> name((size_t)std::max(maxLength, 1));
+    for (GLint i = 0; i < count; ++i) {
+        UniformInfo info;
+        GLsizei length = 0;
+        glGetActiveUniform(program, (GLuint)i, (GLsizei)name.size(), &length, &info.size, &info.type, name.data());
+        info.name.assign(name.data(), (size_t)length);
+        // Uniforms dentro de blocos não têm localização
+        info.location = glGetUniformLocation(program, info.name.c_str());
+        if (info.name.size() > 3 && info.name.compare(info.name.size() - 3, 3, "[0]") == 0)
+            info.name.resize(info.name.size() - 3);
+        Uniforms.push_back(info);
+    }
+    std::sort(Uniforms.begin(), Uniforms.end(),
+              [](const UniformInfo& a, const UniformInfo& b) { return a.name < b.name; });
+}
+
+GLint ShaderProgram::location(const std::string& name) const
+{
+    std::vector<UniformInfo>::const_iterator it = std::lower_bound(
+        Uniforms.begin(), Uniforms.end(), name,
+        [](const UniformInfo& info, const std::string& key) { return info.name < key; });
+    return it != Uniforms.end() && it->name == name ? it->location : -1;
+}
+
+bool ShaderProgram::bindUniformBlock(const char* blockName, GLuint binding) const
+{
+    GLuint index = glGetUniformBlockIndex(Program, blockName);
+    if (index == GL_INVALID_INDEX)
+        return false;
+    glUniformBlockBinding(Program, index, binding);
+    return true;
+}
+
+void UniformBuffer::create(size_t size, GLuint binding)
+{
+    glGenBuffers(1, &Buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, Buffer);
+    glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, Buffer);
+}
+
+void UniformBuffer::update(const void* data, size_t size)
+{
+    glBindBuffer(GL_UNIFORM_BUFFER, Buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, (GLsizeiptr)size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformBuffer::release()
+{
+    if (Buffer)
+        glDeleteBuffers(1, &Buffer);
+    Buffer = 0;
+}
@@ -0,0 +1,258 @@
+#include "SplinePath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// Gauss-Legendre de 5 pontos em [-1, 1]: exato para polinômios de grau até 9,
+// e a velocidade |p'(t)| de uma cúbica é suave dentro de um trecho
+const double GAUSS_NODES[5] = {-0.9061798459386640, -0.5384693101056831, 0.0,
+                               0.5384693101056831, 0.9061798459386640};
+const double GAUSS_WEIGHTS[5] = {0.2369268850561891, 0.4786286704993665, 0.5688888888888889,
+                                 0.4786286704993665, 0.2369268850561891};
+
+// Parametrização centrípeta: |p_i+1 - p_i|^0.5 entre os nós
+float knotInterval(const glm::vec3& p0, const glm::vec3& p1)
+{
+    return std::max(std::sqrt(glm::length(p1 - p0)), 1e-4f);
+}
+
+} // namespace
+
+void SplinePath::clear()
+{
+    Segments.clear();
+    SegmentStart.clear();
+    SampleLength.clear();
+}
+
+void SplinePath::addSegment(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d)
+{
+    Segments.push_back({a, b, c, d});
+}
+
+bool SplinePath::build(const std::vector<glm::vec3>& points, SplineType type, bool closed, int samplesPerSegment)
+{
+    clear();
+    Closed = closed;
+    Samples = std::max(1, samplesPerSegment);
+    size_t n = points.size();
+
+    if (type == SPLINE_LINEAR) {
+        if (n < 2)
+            return false;
+        size_t count = closed ? n : n - 1;
+        Segments.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const glm::vec3& p0 = points[i];
+            const glm::vec3& p1 = points[(i + 1) % n];
+            addSegment(glm::vec3(0.0f), glm::vec3(0.0f), p1 - p0, p0);
+        }
+    } else if (type == SPLINE_CATMULL_ROM) {
+        if (n < 2)
+            return false;
+        size_t count = closed ? n : n - 1;
+        Segments.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec3 p1 = points[i];
+            glm::vec3 p2 = points[(i + 1) % n];
+            // Nas pontas de um caminho aberto, o vizinho que falta é o reflexo do outro
+            glm::vec3 p0 = closed ? points[(i + n - 1) % n] : (i > 0 ? points[i - 1] : 2.0f * p1 - p2);
+            glm::vec3 p3 = closed ? points[(i + 2) % n] : (i + 2 < n ? points[i + 2] : 2.0f * p2 - p1);
+
+            // Tangentes da Catmull-Rom centrípeta já escaladas para t em [0, 1]
+            float t01 = knotInterval(p0, p1), t12 = knotInterval(p1, p2), t23 = knotInterval(p2, p3);
+            glm::vec3 m1 = p2 - p1 + t12 * ((p1 - p0) / t01 - (p2 - p0) / (t01 + t12));
+            glm::vec3 m2 = p2 - p1 + t12 * ((p3 - p2) / t23 - (p3 - p1) / (t12 + t23));
+
+            // Hermite cúbica
+            addSegment(2.0f * (p1 - p2) + m1 + m2, 3.0f * (p2 - p1) - 2.0f * m1 - m2, m1, p1);
+        }
+    } else {
+        if (closed ? n < 3 : n < 4)
+            return false;
+        size_t count = closed ? n / 3 : (n - 1) / 3;
+        size_t used = closed ? count * 3 : count * 3 + 1;
+        if (used != n)
+            std::cout << "Bézier: " << n - used << " pontos de controle sobrando ignorados" << std::endl;
+        Segments.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            const glm::vec3& p0 = points[3 * i];
+            const glm::vec3& p1 = points[3 * i + 1];
+            const glm::vec3& p2 = points[3 * i + 2];
+            const glm::vec3& p3 = points[(3 * i + 3) % used];
+            addSegment(p3 - 3.0f * p2 + 3.0f * p1 - p0, 3.0f * (p2 - 2.0f * p1 + p0), 3.0f * (p1 - p0), p0);
+        }
+    }
+
+    buildLengthTable();
+    return true;
+}
+
+void SplinePath::buildLengthTable()
+{
+    SegmentStart.resize(Segments.size() + 1);
+    SampleLength.resize(Segments.size() * Samples);
+    double total = 0.0;
+    for (size_t s = 0; s < Segments.size(); ++s) {
+        const Cubic& cubic = Segments[s];
+        // p'(t) = 3a t² + 2b t + c
+        glm::vec3 a3 = 3.0f * cubic.a, b2 = 2.0f * cubic.b, c = cubic.c;
+        SegmentStart[s] = total;
+        double segment = 0.0;
+        for (int k = 0; k < Samples; ++k) {
+            double t0 = (double)k / Samples, half = 0.5 / Samples, mid = t0 + half;
+            double sum = 0.0;
+            for (int g = 0; g < 5; ++g) {
+                float t = (float)(mid + half * GAUSS_NODES[g]);
+                sum += GAUSS_WEIGHTS[g] * glm::length((a3 * t + b2) * t + c);
+            }
+            segment += half * sum;
+            SampleLength[s * Samples + k] = (float)segment;
+        }
+        total += segment;
+    }
+    SegmentStart.back() = total;
+}
+
+double SplinePath::wrap(double distance) const
+{
+    double total = length();
+    if (total <= 0.0)
+        return 0.0;
+    if (Closed) {
+        distance = std::fmod(distance, total);
+        return distance < 0.0 ? distance + total : distance;
+    }
+    return std::min(std::max(distance, 0.0), total);
+}
+
+float SplinePath::intervalLength(size_t interval) const
+{
+    int k = (int)(interval % Samples);
+    return k > 0 ? SampleLength[interval] - SampleLength[interval - 1] : SampleLength[interval];
+}
+
+double SplinePath::intervalStart(size_t interval) const
+{
+    int k = (int)(interval % Samples);
+    return SegmentStart[interval / Samples] + (k > 0 ? SampleLength[interval - 1] : 0.0f);
+}
+
+void SplinePath::locateInterval(double distance, size_t& interval, float& offset) const
+{
+    interval = 0;
+    offset = 0.0f;
+    if (Segments.empty())
+        return;
+    double d = wrap(distance);
+
+    size_t s = std::upper_bound(SegmentStart.begin(), SegmentStart.end(), d) - SegmentStart.begin();
+    size_t segment = std::min(s > 0 ? s - 1 : 0, Segments.size() - 1);
+
+    float local = (float)(d - SegmentStart[segment]);
+    const float* samples = &SampleLength[segment * Samples];
+    int k = (int)std::min<ptrdiff_t>(std::lower_bound(samples, samples + Samples, local) - samples, Samples - 1);
+    interval = segment * Samples + k;
+    offset = std::max(local - (k > 0 ? samples[k - 1] : 0.0f), 0.0f);
+}
+
+void SplinePath::intervalInverse(size_t interval, float c[4]) const
+{
+    const Cubic& cubic = Segments[interval / Samples];
+    int k = (int)(interval % Samples);
+    float t0 = (float)k / Samples, dt = 1.0f / Samples;
+    float length = intervalLength(interval);
+    c[0] = t0;
+    c[1] = c[2] = c[3] = 0.0f;
+    if (length <= 0.0f)
+        return;
+
+    // Derivadas em v = u / length; limitadas a 3 dt (Fritsch-Carlson) para t não voltar
+    glm::vec3 a3 = 3.0f * cubic.a, b2 = 2.0f * cubic.b;
+    float speed0 = glm::length((a3 * t0 + b2) * t0 + cubic.c);
+    float speed1 = glm::length((a3 * (t0 + dt) + b2) * (t0 + dt) + cubic.c);
+    float m0 = speed0 > 0.0f ? std::min(length / speed0, 3.0f * dt) : dt;
+    float m1 = speed1 > 0.0f ? std::min(length / speed1, 3.0f * dt) : dt;
+
+    float inverse = 1.0f / length;
+    c[1] = m0 * inverse;
+    c[2] = (3.0f * dt - 2.0f * m0 - m1) * inverse * inverse;
+    c[3] = (m0 + m1 - 2.0f * dt) * inverse * inverse * inverse;
+}
+
+void SplinePath::locate(double distance, size_t& segment, float& t) const
+{
+    segment = 0;
+    t = 0.0f;
+    if (Segments.empty())
+        return;
+
+    // Dentro do trecho, o comprimento começa tomado como linear em t
+    size_t interval;
+    float offset;
+    locateInterval(distance, interval, offset);
+    segment = interval / Samples;
+    int k = (int)(interval % Samples);
+    float length = intervalLength(interval);
+    float f = length > 0.0f ? std::min(offset / length, 1.0f) : 0.0f;
+    float t0 = (float)k / Samples, t1 = (float)(k + 1) / Samples;
+    t = t0 + f * (t1 - t0);
+
+    // Um passo de Newton corrige o erro da interpolação linear (~1% de
+    // velocidade com 8 trechos): integra de t0 até t e anda ao longo de |p'(t)|
+    const Cubic& c = Segments[segment];
+    glm::vec3 a3 = 3.0f * c.a, b2 = 2.0f * c.b;
+    float half = 0.5f * (t - t0), mid = t0 + half, arc = 0.0f;
+    for (int g = 0; g < 5; ++g) {
+        float x = mid + half * (float)GAUSS_NODES[g];
+        arc += (float)GAUSS_WEIGHTS[g] * glm::length((a3 * x + b2) * x + c.c);
+    }
+    float speed = glm::length((a3 * t + b2) * t + c.c);
+    if (speed > 0.0f)
+        t = std::min(std::max(t - (half * arc - offset) / speed, t0), t1);
+}
+
+glm::vec3 SplinePath::segmentPoint(size_t segment, float t) const
+{
+    const Cubic& c = Segments[segment];
+    return ((c.a * t + c.b) * t + c.c) * t + c.d;
+}
+
+glm::vec3 SplinePath::position(double distance) const
+{
+    if (Segments.empty())
+        return glm::vec3(0.0f);
+    size_t segment;
+    float t;
+    locate(distance, segment, t);
+    return segmentPoint(segment, t);
+}
+
+glm::vec3 SplinePath::direction(double distance) const
+{
+    if (Segments.empty())
+        return glm::vec3(0.0f);
+    size_t segment;
+    float t;
+    locate(distance, segment, t);
+    const Cubic& c = Segments[segment];
+    glm::vec3 derivative = (3.0f * c.a * t + 2.0f * c.b) * t + c.c;
+    float speed = glm::length(derivative);
+    return speed > 0.0f ? derivative / speed : glm::vec3(0.0f);
+}
+
+bool parseSplineType(const std::string& name, SplineType& type)
+{
+    if (name == "linear")
+        type = SPLINE_LINEAR;
+    else if (name == "catmull-rom" || name == "catmull")
+        type = SPLINE_CATMULL_ROM;
+    else if (name == "bezier")
+        type = SPLINE_BEZIER;
+    else
+        return false;
+    return true;
+}
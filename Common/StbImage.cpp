@@ -0,0 +1,7 @@
+// Implementação única da stb_image, compartilhada pelos exercícios e pelo TextureStreamer
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+// Também a stb_image_write (PNGs do GoldenTest e da captura de --capture)
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
@@ -0,0 +1,157 @@
+#include "TextureCache.h"
+#include "TextureStreamer.h"
+#include "KtxFile.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+
+#include <filesystem>
+#include <iostream>
+
+#include <stb_image.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// O que o streamer vai ocupar na GPU: o .ktx do TexBake quando ele for usado
+// (níveis já comprimidos), senão o nível 0 com os canais enviados (3 ou 4) + 1/3 para os mipmaps
+size_t estimateTextureBytes(const std::string& path, const MappedFile& file, bool acceptCompressed)
+{
+    std::string bakedPath = bakedTexturePath(path);
+    if (!bakedPath.empty()) {
+        KtxImage baked;
+        if (readKTXInfo(bakedPath, baked) && (acceptCompressed || !baked.compressed()))
+            return baked.levelBytes();
+    }
+    int width = 0, height = 0, channels = 0;
+    if (!stbi_info_from_memory((const stbi_uc*)file.data(), (int)file.size(), &width, &height, &channels))
+        return 0;
+    return (size_t)width * height * (channels == 3 ? 3 : 4) * 4 / 3;
+}
+
+} // namespace
+
+TextureCache::TextureCache(TextureStreamer& streamer, size_t vramBudget)
+    : Streamer(streamer), Budget(vramBudget)
+{
+}
+
+TextureCache::~TextureCache()
+{
+    clear();
+}
+
+GLuint TextureCache::acquire(const std::string& filePath)
+{
+    std::error_code ec;
+    std::string canonical = fs::weakly_canonical(filePath, ec).string();
+    if (ec)
+        canonical = filePath;
+
+    uint64_t size = fs::file_size(canonical, ec);
+    if (ec)
+        size = 0;
+    int64_t mtime = (int64_t)fs::last_write_time(canonical, ec).time_since_epoch().count();
+    if (ec)
+        mtime = 0;
+
+    // O hash só é recalculado quando o arquivo muda
+    std::unordered_map<std::string, PathInfo>::iterator path = Paths.find(canonical);
+    bool known = path != Paths.end() && path->second.size == size && path->second.mtime == mtime;
+    if (!known) {
+        PathInfo info;
+        info.size = size;
+        info.mtime = mtime;
+        MappedFile file;
+        if (file.open(canonical) && file.size() > 0) {
+            info.key = hashBytes(file.data(), file.size());
+            info.bytes = estimateTextureBytes(canonical, file, Streamer.compressedSupported());
+        } else {
+            // Arquivo inexistente: o streamer reporta o erro e fica a imagem provisória
+            info.key = hashBytes(canonical.data(), canonical.size()) ^ 0x9E3779B97F4A7C15ull;
+        }
+        path = Paths.insert_or_assign(canonical, info).first;
+    }
+
+    uint64_t key = path->second.key;
+    std::unordered_map<uint64_t, Entry>::iterator it = Entries.find(key);
+    if (it != Entries.end()) {
+        Hits++;
+        Entry& entry = it->second;
+        if (entry.refCount++ == 0)
+            Unused.erase(entry.lru);
+        return entry.texID;
+    }
+
+    Misses++;
+    Entry entry;
+    entry.texID = Streamer.request(filePath);
+    entry.refCount = 1;
+    entry.bytes = path->second.bytes;
+    VramBytes += entry.bytes;
+    Entries[key] = entry;
+    Keys[entry.texID] = key;
+
+    evictToBudget();
+    return entry.texID;
+}
+
+void TextureCache::release(GLuint texID)
+{
+    std::unordered_map<GLuint, uint64_t>::iterator key = Keys.find(texID);
+    if (key == Keys.end())
+        return;
+    Entry& entry = Entries[key->second];
+    if (entry.refCount == 0)
+        return;
+    if (--entry.refCount == 0) {
+        Unused.push_front(key->second);
+        entry.lru = Unused.begin();
+        evictToBudget();
+    }
+}
+
+void TextureCache::setBudget(size_t bytes)
+{
+    Budget = bytes;
+    evictToBudget();
+}
+
+void TextureCache::evictToBudget()
+{
+    std::list<uint64_t>::iterator it = Unused.end();
+    while (VramBytes > Budget && it != Unused.begin()) {
+        --it;
+        Entry& entry = Entries[*it];
+        // Ainda chegando pelo streamer: apagar agora faria o envio recriar o nome
+        if (Streamer.isPending(entry.texID))
+            continue;
+
+        glDeleteTextures(1, &entry.texID);
+        VramBytes -= entry.bytes;
+        Evictions++;
+        Keys.erase(entry.texID);
+        uint64_t key = *it;
+        it = Unused.erase(it);
+        Entries.erase(key);
+    }
+}
+
+void TextureCache::clear()
+{
+    // Pendentes também: o streamer desiste delas antes de o nome ser apagado
+    for (const std::pair<const uint64_t, Entry>& item : Entries) {
+        Streamer.cancel(item.second.texID);
+        glDeleteTextures(1, &item.second.texID);
+    }
+    Entries.clear();
+    Keys.clear();
+    Unused.clear();
+    VramBytes = 0;
+}
+
+void TextureCache::printStats() const
+{
+    std::cout << "Texturas: " << Entries.size() << " na GPU (~" << VramBytes / 1024 << " KB), "
+              << Hits << " reaproveitadas, " << Misses << " carregadas, " << Evictions << " descartadas" << std::endl;
+}
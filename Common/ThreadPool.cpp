@@ -0,0 +1,103 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(unsigned workerCount)
+{
+    Workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i)
+        Workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Stopping = true;
+    }
+    Available.notify_all();
+    for (std::thread& worker : Workers)
+        worker.join();
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    if (Workers.empty()) {
+        task();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(Mutex);
+        Tasks.push_back(std::move(task));
+    }
+    Available.notify_one();
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(Mutex);
+            Available.wait(lock, [this] { return Stopping || !Tasks.empty(); });
+            if (Tasks.empty())
+                return;
+            task = std::move(Tasks.front());
+            Tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& fn, size_t minBlockSize)
+{
+    if (count == 0)
+        return;
+
+    // Alguns blocos por thread para equilibrar a carga
+    size_t blockSize = std::max(minBlockSize, (count + concurrency() * 4 - 1) / (concurrency() * 4));
+    size_t blockCount = (count + blockSize - 1) / blockSize;
+    if (blockCount == 1 || Workers.empty()) {
+        fn(0, count);
+        return;
+    }
+
+    // Os blocos são retirados de um contador atômico: quem chegar primeiro
+    // (worker ou chamador) executa. Assim a chamada nunca espera por uma tarefa
+    // que ainda está na fila atrás de outra.
+    struct Job {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+
+    auto run = [job, &fn, count, blockSize, blockCount]() {
+        size_t block;
+        while ((block = job->next.fetch_add(1)) < blockCount) {
+            size_t begin = block * blockSize;
+            fn(begin, std::min(count, begin + blockSize));
+            if (job->done.fetch_add(1) + 1 == blockCount) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->finished.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(Workers.size(), blockCount - 1);
+    for (size_t i = 0; i < helpers; ++i)
+        submit(run);
+    run();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&] { return job->done.load() == blockCount; });
+}
+
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
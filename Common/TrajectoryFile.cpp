@@ -0,0 +1,386 @@
+#include "TrajectoryFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char TRAJECTORY_MAGIC[8] = {'T', 'R', 'A', 'J', 'B', 'I', 'N', '\0'};
+const uint32_t TRAJECTORY_VERSION = 2;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint32_t chunkPoints;
+    uint32_t reserved[3];
+};
+static_assert(sizeof(FileHeader) == 32, "cabeçalho do .traj tem 32 bytes");
+
+struct ChunkHeader {
+    uint32_t pointCount;
+    float timeSpan;  // último tempo - baseTime
+    double baseTime; // tempo do primeiro ponto
+    float boundsMin[3];
+    float boundsMax[3];
+};
+static_assert(sizeof(ChunkHeader) == 40, "cabeçalho do bloco tem 40 bytes");
+
+// Só blocos cheios são quantizados; o incompleto do fim fica em float32
+bool chunkQuantized(uint32_t flags, size_t points, size_t chunkPoints)
+{
+    return (flags & TRAJECTORY_QUANTIZED) && points == chunkPoints;
+}
+
+size_t pointBytes(bool quantized)
+{
+    return quantized ? 3 * sizeof(int16_t) : 3 * sizeof(float);
+}
+
+size_t timeBytes(uint32_t flags)
+{
+    return (flags & TRAJECTORY_TIMESTAMPS) ? sizeof(float) : 0;
+}
+
+size_t chunkBytes(uint32_t flags, size_t points, size_t chunkPoints)
+{
+    return sizeof(ChunkHeader) + points * (pointBytes(chunkQuantized(flags, points, chunkPoints)) + timeBytes(flags));
+}
+
+ChunkHeader readChunkHeader(const char* chunk)
+{
+    ChunkHeader header;
+    memcpy(&header, chunk, sizeof(header));
+    return header;
+}
+
+} // namespace
+
+bool TrajectoryReader::open(const std::string& filePath)
+{
+    close();
+    if (!File.open(filePath) || File.size() < HeaderBytes)
+        return false;
+
+    FileHeader header;
+    memcpy(&header, File.data(), sizeof(header));
+    if (memcmp(header.magic, TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC)) != 0 ||
+        header.version != TRAJECTORY_VERSION || header.chunkPoints == 0) {
+        close();
+        return false;
+    }
+    Flags = header.flags;
+    ChunkPoints = header.chunkPoints;
+    ChunkBytes = chunkBytes(Flags, ChunkPoints, ChunkPoints);
+
+    // Blocos cheios e, no fim, talvez um incompleto. O incompleto fica em
+    // float32 e pode ter o tamanho de um ou mais blocos cheios quantizados,
+    // então testa as poucas divisões possíveis conferindo o pointCount
+    size_t dataBytes = File.size() - HeaderBytes;
+    for (size_t full = dataBytes / ChunkBytes + 1; full-- > 0;) {
+        size_t rest = dataBytes - full * ChunkBytes;
+        if (rest > 2 * ChunkBytes)
+            break;
+        if (rest == 0) {
+            if (full > 0 && readChunkHeader(chunk(full - 1)).pointCount != ChunkPoints)
+                continue;
+            Chunks = full;
+            Count = full * ChunkPoints;
+            return true;
+        }
+        if (rest < sizeof(ChunkHeader))
+            continue;
+        ChunkHeader last = readChunkHeader(chunk(full));
+        if (last.pointCount > 0 && last.pointCount < ChunkPoints && chunkBytes(Flags, last.pointCount, ChunkPoints) == rest) {
+            Chunks = full + 1;
+            Count = full * ChunkPoints + last.pointCount;
+            return true;
+        }
+    }
+    close();
+    return false;
+}
+
+void TrajectoryReader::close()
+{
+    File.close();
+    Flags = ChunkPoints = 0;
+    ChunkBytes = Chunks = Count = 0;
+}
+
+glm::vec3 TrajectoryReader::point(size_t i) const
+{
+    const char* base = chunk(i / ChunkPoints);
+    size_t k = i % ChunkPoints;
+    ChunkHeader header = readChunkHeader(base);
+    if (chunkQuantized(Flags, header.pointCount, ChunkPoints)) {
+        int16_t q[3];
+        memcpy(q, base + sizeof(ChunkHeader) + k * sizeof(q), sizeof(q));
+        glm::vec3 p;
+        for (int c = 0; c < 3; ++c)
+            p[c] = header.boundsMin[c] + (q[c] + 32768) * ((header.boundsMax[c] - header.boundsMin[c]) / 65535.0f);
+        return p;
+    }
+    float p[3];
+    memcpy(p, base + sizeof(ChunkHeader) + k * sizeof(p), sizeof(p));
+    return glm::vec3(p[0], p[1], p[2]);
+}
+
+double TrajectoryReader::time(size_t i) const
+{
+    if (!hasTimestamps())
+        return 0.0;
+    const char* base = chunk(i / ChunkPoints);
+    ChunkHeader header = readChunkHeader(base);
+    float offset;
+    size_t positions = header.pointCount * pointBytes(chunkQuantized(Flags, header.pointCount, ChunkPoints));
+    memcpy(&offset, base + sizeof(ChunkHeader) + positions + (i % ChunkPoints) * sizeof(float), sizeof(offset));
+    return header.baseTime + offset;
+}
+
+void TrajectoryReader::readPoints(size_t first, size_t count, glm::vec3* out) const
+{
+    count = std::min(count, Count - std::min(first, Count));
+    for (size_t n = 0; n < count;) {
+        size_t i = first + n;
+        const char* base = chunk(i / ChunkPoints);
+        size_t k = i % ChunkPoints;
+        ChunkHeader header = readChunkHeader(base);
+        size_t run = std::min<size_t>(header.pointCount - k, count - n);
+        const char* data = base + sizeof(ChunkHeader);
+        if (chunkQuantized(Flags, header.pointCount, ChunkPoints)) {
+            glm::vec3 lo(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+            glm::vec3 scale = (glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]) - lo) / 65535.0f;
+            for (size_t j = 0; j < run; ++j) {
+                int16_t q[3];
+                memcpy(q, data + (k + j) * sizeof(q), sizeof(q));
+                out[n + j] = lo + glm::vec3(q[0] + 32768.0f, q[1] + 32768.0f, q[2] + 32768.0f) * scale;
+            }
+        } else {
+            // glm::vec3 são 3 floats seguidos: cópia direta do trecho
+            memcpy(out + n, data + k * 3 * sizeof(float), run * 3 * sizeof(float));
+        }
+        n += run;
+    }
+}
+
+void TrajectoryReader::readAll(std::vector<glm::vec3>& points) const
+{
+    points.resize(Count);
+    readPoints(0, Count, points.data());
+}
+
+size_t TrajectoryReader::findTime(double t) const
+{
+    // Primeiro bloco que termina em t ou depois
+    size_t lo = 0, hi = Chunks;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        ChunkHeader header = readChunkHeader(chunk(mid));
+        if (header.baseTime + header.timeSpan < t)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo == Chunks)
+        return Count;
+
+    size_t first = lo * ChunkPoints, last = std::min(first + ChunkPoints, Count);
+    while (first < last) {
+        size_t mid = (first + last) / 2;
+        if (time(mid) < t)
+            first = mid + 1;
+        else
+            last = mid;
+    }
+    return first;
+}
+
+TrajectoryWriter::~TrajectoryWriter()
+{
+    close();
+}
+
+bool TrajectoryWriter::open(const std::string& filePath, uint32_t flags, uint32_t chunkPoints)
+{
+    close();
+    Pending.clear();
+    PendingTimes.clear();
+    FullChunks = 0;
+    LastTime = 0.0;
+
+    std::error_code ec;
+    if (fs::exists(filePath, ec) && fs::file_size(filePath, ec) > 0) {
+        // Continua de onde parou: o bloco incompleto volta para a memória
+        TrajectoryReader reader;
+        if (!reader.open(filePath)) {
+            std::cerr << "Arquivo de trajetória inválido: " << filePath << std::endl;
+            return false;
+        }
+        Flags = reader.flags();
+        ChunkPoints = reader.chunkPoints();
+        FullChunks = reader.size() / ChunkPoints;
+        for (size_t i = FullChunks * ChunkPoints; i < reader.size(); ++i) {
+            Pending.push_back(reader.point(i));
+            PendingTimes.push_back(reader.time(i));
+        }
+        LastTime = reader.size() > 0 ? reader.time(reader.size() - 1) : 0.0;
+        reader.close();
+        File.open(filePath, std::ios::in | std::ios::out | std::ios::binary);
+    } else {
+        Flags = flags;
+        ChunkPoints = std::max<uint32_t>(1, chunkPoints);
+        File.open(filePath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (File.is_open()) {
+            FileHeader header = {};
+            memcpy(header.magic, TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC));
+            header.version = TRAJECTORY_VERSION;
+            header.flags = Flags;
+            header.chunkPoints = ChunkPoints;
+            File.write((const char*)&header, sizeof(header));
+        }
+    }
+    if (!File.is_open()) {
+        std::cerr << "Erro ao abrir arquivo de trajetória: " << filePath << std::endl;
+        return false;
+    }
+    ChunkBytes = chunkBytes(Flags, ChunkPoints, ChunkPoints);
+    FilePath = filePath;
+    Dirty = false;
+    return (bool)File;
+}
+
+bool TrajectoryWriter::append(const glm::vec3& point, double time)
+{
+    if (!File.is_open())
+        return false;
+    // Tempos fora de ordem quebrariam a busca por tempo
+    if ((Flags & TRAJECTORY_TIMESTAMPS) && size() > 0)
+        time = std::max(time, LastTime);
+    LastTime = time;
+    Pending.push_back(point);
+    PendingTimes.push_back(time);
+    Dirty = true;
+    if (Pending.size() < ChunkPoints)
+        return true;
+
+    bool ok = writeChunk();
+    FullChunks++;
+    Pending.clear();
+    PendingTimes.clear();
+    Dirty = false;
+    return ok;
+}
+
+bool TrajectoryWriter::writeChunk()
+{
+    ChunkHeader header = {};
+    header.pointCount = (uint32_t)Pending.size();
+    glm::vec3 lo = Pending[0], hi = Pending[0];
+    for (const glm::vec3& p : Pending) {
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    for (int c = 0; c < 3; ++c) {
+        header.boundsMin[c] = lo[c];
+        header.boundsMax[c] = hi[c];
+    }
+    if (Flags & TRAJECTORY_TIMESTAMPS) {
+        header.baseTime = PendingTimes.front();
+        header.timeSpan = (float)(PendingTimes.back() - PendingTimes.front());
+    }
+
+    // O bloco incompleto vai em float32 mesmo com TRAJECTORY_QUANTIZED: ao
+    // continuar o arquivo os pontos voltam exatos, e cada bloco é quantizado
+    // uma única vez, quando enche, a partir dos valores originais
+    bool quantized = chunkQuantized(Flags, Pending.size(), ChunkPoints);
+    std::vector<char> bytes(chunkBytes(Flags, Pending.size(), ChunkPoints));
+    memcpy(bytes.data(), &header, sizeof(header));
+    char* data = bytes.data() + sizeof(header);
+    if (quantized) {
+        glm::vec3 extent = hi - lo;
+        for (size_t i = 0; i < Pending.size(); ++i) {
+            int16_t q[3];
+            for (int c = 0; c < 3; ++c) {
+                float unit = extent[c] > 0.0f ? (Pending[i][c] - lo[c]) / extent[c] : 0.0f;
+                q[c] = (int16_t)(std::min(std::max((long)std::lround(unit * 65535.0f), 0L), 65535L) - 32768);
+            }
+            memcpy(data + i * sizeof(q), q, sizeof(q));
+        }
+    } else {
+        memcpy(data, Pending.data(), Pending.size() * 3 * sizeof(float));
+    }
+    if (Flags & TRAJECTORY_TIMESTAMPS) {
+        char* times = data + Pending.size() * pointBytes(quantized);
+        for (size_t i = 0; i < PendingTimes.size(); ++i) {
+            float offset = (float)(PendingTimes[i] - header.baseTime);
+            memcpy(times + i * sizeof(float), &offset, sizeof(offset));
+        }
+    }
+
+    // Só o último bloco é (re)escrito; os anteriores ficam intactos
+    size_t offset = sizeof(FileHeader) + FullChunks * ChunkBytes;
+    File.seekp((std::streamoff)offset);
+    File.write(bytes.data(), (std::streamsize)bytes.size());
+    if (quantized && File) {
+        // O bloco em float32 que ele substitui ocupava mais: corta o que sobrou
+        File.flush();
+        std::error_code ec;
+        if (fs::file_size(FilePath, ec) > offset + bytes.size() && !ec)
+            fs::resize_file(FilePath, offset + bytes.size(), ec);
+        if (ec)
+            return false;
+    }
+    return (bool)File;
+}
+
+bool TrajectoryWriter::flush()
+{
+    if (!File.is_open())
+        return false;
+    bool ok = true;
+    if (Dirty && !Pending.empty())
+        ok = writeChunk();
+    Dirty = false;
+    File.flush();
+    return ok && (bool)File;
+}
+
+void TrajectoryWriter::close()
+{
+    if (!File.is_open())
+        return;
+    flush();
+    File.close();
+}
+
+long convertTextTrajectory(const std::string& textPath, const std::string& binaryPath, uint32_t flags,
+                           uint32_t chunkPoints)
+{
+    std::ifstream text(textPath);
+    if (!text.is_open()) {
+        std::cerr << "Erro ao abrir arquivo de trajetória: " << textPath << std::endl;
+        return -1;
+    }
+    std::error_code ec;
+    fs::remove(binaryPath, ec);
+    TrajectoryWriter writer;
+    if (!writer.open(binaryPath, flags, chunkPoints))
+        return -1;
+
+    long count = 0;
+    float x, y, z;
+    while (text >> x >> y >> z) {
+        // Sem tempo no texto: um ponto por segundo
+        if (!writer.append(glm::vec3(x, y, z), (double)count))
+            return -1;
+        count++;
+    }
+    writer.close();
+    return count;
+}
@@ -0,0 +1,214 @@
+#include "TransformStore.h"
+
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// R = Rx(a) * Ry(b) * Rz(c), escrita diretamente por colunas:
+//   col0 = ( cb*cc,  ca*sc + sa*sb*cc,  sa*sc - ca*sb*cc)
+//   col1 = (-cb*sc,  ca*cc - sa*sb*sc,  sa*cc + ca*sb*sc)
+//   col2 = ( sb,    -sa*cb,             ca*cb           )
+glm::mat4 composeTRS(const glm::vec3& position, const glm::vec3& rotation, float scale)
+{
+    float sa = std::sin(rotation.x), ca = std::cos(rotation.x);
+    float sb = std::sin(rotation.y), cb = std::cos(rotation.y);
+    float sc = std::sin(rotation.z), cc = std::cos(rotation.z);
+
+    glm::mat4 m;
+    m[0] = glm::vec4(cb * cc, ca * sc + sa * sb * cc, sa * sc - ca * sb * cc, 0.0f) * scale;
+    m[1] = glm::vec4(-cb * sc, ca * cc - sa * sb * sc, sa * cc + ca * sb * sc, 0.0f) * scale;
+    m[2] = glm::vec4(sb, -sa * cb, ca * cb, 0.0f) * scale;
+    m[3] = glm::vec4(position, 1.0f);
+    return m;
+}
+
+size_t TransformStore::add(const glm::vec3& position, const glm::vec3& rotation, float scale)
+{
+    size_t i = size();
+    PosX.push_back(position.x); PosY.push_back(position.y); PosZ.push_back(position.z);
+    RotX.push_back(rotation.x); RotY.push_back(rotation.y); RotZ.push_back(rotation.z);
+    Scale.push_back(scale);
+    Matrices.push_back(glm::mat4(1.0f));
+    if ((i >> 6) >= Dirty.size())
+        Dirty.push_back(0);
+    markDirty(i);
+    return i;
+}
+
+void TransformStore::reserve(size_t count)
+{
+    PosX.reserve(count); PosY.reserve(count); PosZ.reserve(count);
+    RotX.reserve(count); RotY.reserve(count); RotZ.reserve(count);
+    Scale.reserve(count);
+    Matrices.reserve(count);
+    Dirty.reserve((count + 63) / 64);
+}
+
+void TransformStore::clear()
+{
+    PosX.clear(); PosY.clear(); PosZ.clear();
+    RotX.clear(); RotY.clear(); RotZ.clear();
+    Scale.clear();
+    Matrices.clear();
+    Dirty.clear();
+}
+
+void TransformStore::setPosition(size_t i, const glm::vec3& position)
+{
+    PosX[i] = position.x; PosY[i] = position.y; PosZ[i] = position.z;
+    markDirty(i);
+}
+
+void TransformStore::setRotation(size_t i, const glm::vec3& rotation)
+{
+    RotX[i] = rotation.x; RotY[i] = rotation.y; RotZ[i] = rotation.z;
+    markDirty(i);
+}
+
+void TransformStore::setScale(size_t i, float scale)
+{
+    Scale[i] = scale;
+    markDirty(i);
+}
+
+void TransformStore::markAllDirty()
+{
+    for (uint64_t& word : Dirty)
+        word = ~0ull;
+    if (size() & 63)
+        Dirty.back() = (1ull << (size() & 63)) - 1;
+}
+
+void TransformStore::composeScalar(size_t i)
+{
+    Matrices[i] = composeTRS(position(i), rotation(i), Scale[i]);
+}
+
+#ifdef __SSE2__
+
+namespace {
+
+// Seno e cosseno de 4 ângulos: redução a [-pi/4, pi/4] pelo quadrante
+// (pi/2 dividido em três partes, Cody-Waite) e os polinômios do Cephes (sinf/cosf)
+inline void sincos4(__m128 x, __m128& s, __m128& c)
+{
+    __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.636619772f)));
+    __m128 qf = _mm_cvtepi32_ps(q);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(1.5703125f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(4.837512969970703125e-4f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(7.54978995489188216e-8f)));
+    __m128 r2 = _mm_mul_ps(r, r);
+
+    __m128 ps = _mm_add_ps(_mm_set1_ps(8.3321608736e-3f), _mm_mul_ps(r2, _mm_set1_ps(-1.9515295891e-4f)));
+    ps = _mm_add_ps(_mm_set1_ps(-1.6666654611e-1f), _mm_mul_ps(r2, ps));
+    ps = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), ps));
+
+    __m128 pc = _mm_add_ps(_mm_set1_ps(-1.388731625493765e-3f), _mm_mul_ps(r2, _mm_set1_ps(2.443315711809948e-5f)));
+    pc = _mm_add_ps(_mm_set1_ps(4.166664568298827e-2f), _mm_mul_ps(r2, pc));
+    pc = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_mul_ps(_mm_mul_ps(r2, r2), pc));
+
+    // Quadrante ímpar troca seno e cosseno; os bits de sinal vêm de q e q + 1
+    const __m128i one = _mm_set1_epi32(1);
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+    __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), _mm_set1_epi32(2)), 30));
+    s = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps)), sinSign);
+    c = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc)), cosSign);
+}
+
+inline __m128 gather4(const std::vector<float>& values, const uint32_t* indices, bool contiguous)
+{
+    if (contiguous)
+        return _mm_loadu_ps(values.data() + indices[0]);
+    return _mm_setr_ps(values[indices[0]], values[indices[1]], values[indices[2]], values[indices[3]]);
+}
+
+} // namespace
+
+// Quatro objetos por vez: cada __m128 guarda o mesmo elemento de quatro
+// matrizes; a transposição 4x4 devolve as colunas de cada uma.
+void TransformStore::composeBatch(const uint32_t* indices)
+{
+    bool contiguous = indices[3] == indices[0] + 3 && indices[1] == indices[0] + 1 && indices[2] == indices[0] + 2;
+    __m128 sa, ca, sb, cb, sc, cc;
+    sincos4(gather4(RotX, indices, contiguous), sa, ca);
+    sincos4(gather4(RotY, indices, contiguous), sb, cb);
+    sincos4(gather4(RotZ, indices, contiguous), sc, cc);
+    __m128 s = gather4(Scale, indices, contiguous);
+
+    __m128 sasb = _mm_mul_ps(sa, sb);
+    __m128 casb = _mm_mul_ps(ca, sb);
+    __m128 cols[4][4];
+    cols[0][0] = _mm_mul_ps(s, _mm_mul_ps(cb, cc));
+    cols[0][1] = _mm_mul_ps(s, _mm_add_ps(_mm_mul_ps(ca, sc), _mm_mul_ps(sasb, cc)));
+    cols[0][2] = _mm_mul_ps(s, _mm_sub_ps(_mm_mul_ps(sa, sc), _mm_mul_ps(casb, cc)));
+    cols[1][0] = _mm_mul_ps(s, _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(cb, sc)));
+    cols[1][1] = _mm_mul_ps(s, _mm_sub_ps(_mm_mul_ps(ca, cc), _mm_mul_ps(sasb, sc)));
+    cols[1][2] = _mm_mul_ps(s, _mm_add_ps(_mm_mul_ps(sa, cc), _mm_mul_ps(casb, sc)));
+    cols[2][0] = _mm_mul_ps(s, sb);
+    cols[2][1] = _mm_mul_ps(s, _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(sa, cb)));
+    cols[2][2] = _mm_mul_ps(s, _mm_mul_ps(ca, cb));
+    cols[3][0] = gather4(PosX, indices, contiguous);
+    cols[3][1] = gather4(PosY, indices, contiguous);
+    cols[3][2] = gather4(PosZ, indices, contiguous);
+    cols[0][3] = cols[1][3] = cols[2][3] = _mm_setzero_ps();
+    cols[3][3] = _mm_set1_ps(1.0f);
+
+    for (int k = 0; k < 4; ++k) {
+        __m128 x = cols[k][0], y = cols[k][1], z = cols[k][2], w = cols[k][3];
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(&Matrices[indices[0]][k][0], x);
+        _mm_storeu_ps(&Matrices[indices[1]][k][0], y);
+        _mm_storeu_ps(&Matrices[indices[2]][k][0], z);
+        _mm_storeu_ps(&Matrices[indices[3]][k][0], w);
+    }
+}
+
+#endif
+
+size_t TransformStore::update(std::vector<uint32_t>* changed)
+{
+    size_t updated = 0;
+#ifdef __SSE2__
+    uint32_t batch[4];
+    int batchSize = 0;
+#endif
+    for (size_t word = 0; word < Dirty.size(); ++word) {
+        uint64_t bits = Dirty[word];
+        Dirty[word] = 0;
+        while (bits) {
+#if defined(__GNUC__)
+            int bit = __builtin_ctzll(bits);
+#else
+            int bit = 0;
+            while (!((bits >> bit) & 1))
+                bit++;
+#endif
+            bits &= bits - 1;
+            size_t i = word * 64 + (size_t)bit;
+            updated++;
+            if (changed)
+                changed->push_back((uint32_t)i);
+#ifdef __SSE2__
+            batch[batchSize++] = (uint32_t)i;
+            if (batchSize == 4) {
+                composeBatch(batch);
+                batchSize = 0;
+            }
+#else
+            composeScalar(i);
+#endif
+        }
+    }
+#ifdef __SSE2__
+    // Lote incompleto: repete o último índice (a mesma matriz é escrita de novo)
+    if (batchSize > 0) {
+        for (int k = batchSize; k < 4; ++k)
+            batch[k] = batch[batchSize - 1];
+        composeBatch(batch);
+    }
+#endif
+    return updated;
+}
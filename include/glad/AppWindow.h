@@ -0,0 +1,57 @@
+#ifndef APP_WINDOW_H
+#define APP_WINDOW_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+class Camera;
+
+// Janela dos exercícios e modo sem janela para execuções automáticas.
+//
+//   --headless  contexto sem superfície visível: plataforma nula da GLFW com
+//               EGL (Mesa surfaceless, funciona com llvmpipe sem GPU) ou, se
+//               não houver, uma janela oculta. O desenho vai para um FBO do
+//               tamanho da janela, vinculado no lugar do framebuffer padrão.
+//               O relógio da GLFW avança 1/60 s por quadro, então animações e
+//               câmeras dão sempre o mesmo resultado.
+//   --frames N  encerra depois de N quadros e imprime os tempos de quadro
+//               (sem o primeiro, que inclui a carga dos arquivos).
+//   --capture arquivo.png
+//               grava o último quadro (o de número N; sem --frames, o primeiro).
+//   --uncapped  desliga a sincronia vertical (glfwSwapInterval(0)) para medir
+//               quantos quadros por segundo o exercício consegue desenhar.
+//   --camera-record arquivo.cam
+//               grava a câmera (posição, yaw, pitch) a cada quadro.
+//   --camera-play arquivo.cam
+//               percorre a gravação no lugar do teclado e do mouse; sem
+//               --frames, encerra no fim do percurso. Com --headless, o
+//               percurso é um benchmark determinístico: as mesmas vistas em
+//               todas as execuções, e o relatório aponta os quadros mais lentos
+//               e onde a câmera estava.
+//   --frame-times arquivo.csv
+//               grava o tempo de cada quadro (e a câmera, no percurso).
+//
+// O exercício chama parseAppOptions() no início de main, cria a janela com
+// createAppWindow() (que já chama glfwInit) e troca glfwSwapBuffers por
+// presentFrame(); o laço while (!glfwWindowShouldClose(window)) continua igual.
+void parseAppOptions(int argc, char** argv);
+bool appHeadless();
+
+// Janela com o contexto já corrente e a glad carregada, ou nullptr (com a GLFW encerrada)
+GLFWwindow* createAppWindow(int width, int height, const char* title);
+
+// No lugar de glfwSwapBuffers: conta o quadro e pede para fechar ao chegar em --frames
+void presentFrame(GLFWwindow* window);
+
+// A cada quadro, depois do glfwPollEvents() e logo antes de montar a view:
+// grava a câmera ou a coloca no ponto do percurso. Devolve true se a câmera
+// veio do percurso. Quem interpola a câmera entre passos passa a posição
+// desenhada, que é a gravada.
+bool driveCamera(Camera& camera);
+bool driveCamera(Camera& camera, const glm::vec3& shownPosition);
+
+// FBO de desenho do modo headless (0 com janela visível)
+GLuint appFramebuffer();
+
+#endif
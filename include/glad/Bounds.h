@@ -0,0 +1,64 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// Volumes envolventes de uma malha, no espaço do objeto
+struct MeshBounds {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+    glm::vec3 center = glm::vec3(0.0f); // centro da AABB, também centro da esfera
+    float radius = 0.0f;                // maior distância de center a um vértice
+};
+
+// Caixa alinhada aos eixos no espaço do mundo
+struct Aabb {
+    glm::vec3 min = glm::vec3(0.0f);
+    glm::vec3 max = glm::vec3(0.0f);
+};
+
+// vertices com stride floats por vértice, posição nos três primeiros
+MeshBounds computeBounds(const float* vertices, size_t vertexCount, size_t stride);
+
+// Seis planos (normal para dentro, normalizada) na forma ax + by + cz + d = 0,
+// na ordem esquerda, direita, baixo, cima, perto, longe
+struct Frustum {
+    glm::vec4 planes[6];
+};
+
+// Planos extraídos de projection * view (Gribb e Hartmann): os testes ficam no
+// espaço do mundo
+Frustum extractFrustum(const glm::mat4& viewProjection);
+
+bool sphereInFrustum(const Frustum& frustum, const glm::vec3& center, float radius);
+
+// Esfera da malha levada ao espaço do mundo pela matriz model (raio multiplicado
+// pela maior escala entre os eixos)
+void transformSphere(const MeshBounds& bounds, const glm::mat4& model, glm::vec3& center, float& radius);
+
+// AABB da malha transformada pela matriz model (Arvo): envolve a caixa girada
+Aabb transformAabb(const MeshBounds& bounds, const glm::mat4& model);
+Aabb mergeAabb(const Aabb& a, const Aabb& b);
+float surfaceArea(const Aabb& box);
+
+enum FrustumTest { FRUSTUM_OUTSIDE, FRUSTUM_INTERSECTS, FRUSTUM_INSIDE };
+
+// Teste do vértice positivo/negativo contra cada plano. FRUSTUM_INSIDE quando a
+// caixa inteira está dentro (os filhos não precisam mais ser testados).
+FrustumTest classifyAabb(const Frustum& frustum, const Aabb& box);
+
+// Interseção raio/caixa (slabs) com invDirection = 1 / direção. Retorna false
+// se não houver ponto em [0, maxDistance]; distance recebe a entrada na caixa.
+bool rayIntersectsAabb(const glm::vec3& origin, const glm::vec3& invDirection, const Aabb& box,
+                       float maxDistance, float& distance);
+
+// Testa count esferas dadas em estrutura de arrays (quatro por iteração com
+// SSE2) e escreve em visible os índices das que tocam o frustum, em ordem.
+// Retorna quantas são visíveis.
+size_t cullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+                   size_t count, uint32_t* visible);
+
+#endif
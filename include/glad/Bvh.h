@@ -0,0 +1,54 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Bounds.h"
+
+// Hierarquia de volumes envolventes (AABB) sobre os objetos da cena.
+// build() divide os objetos pela heurística de área de superfície (SAH, em
+// faixas); update() troca a caixa de um objeto e reajusta só os nós acima
+// dele (refit), sem reconstruir a árvore. Depois de muitos movimentos grandes
+// a árvore perde qualidade: aí vale chamar build() de novo.
+//
+// Os objetos de cada subárvore ficam contíguos em Objects, então um nó
+// inteiramente dentro do frustum é aceito sem descer até as folhas.
+class Bvh {
+public:
+    void build(const Aabb* boxes, size_t count);
+    void update(uint32_t object, const Aabb& box);
+
+    // Acrescenta a visible os objetos cuja caixa toca o frustum. Retorna quantos.
+    size_t cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+    // Objeto mais próximo cuja caixa o raio atravessa, ou -1.
+    // distance recebe a distância (em unidades de direction) até a caixa.
+    int pick(const glm::vec3& origin, const glm::vec3& direction, float& distance) const;
+
+    size_t size() const { return Boxes.size(); }
+    size_t nodeCount() const { return Nodes.size(); }
+    const Aabb& box(uint32_t object) const { return Boxes[object]; }
+
+private:
+    struct Node {
+        Aabb box;
+        uint32_t first = 0;  // primeiro objeto da subárvore em Objects
+        uint32_t count = 0;  // objetos na subárvore
+        uint32_t left = 0;   // filhos em left e left + 1; 0 numa folha
+        uint32_t parent = 0;
+    };
+
+    void split(uint32_t node, const std::vector<glm::vec3>& centroids);
+    Aabb boundsOf(uint32_t first, uint32_t count) const;
+
+    std::vector<Node> Nodes;      // Nodes[0] é a raiz; filhos sempre depois do pai
+    std::vector<Aabb> Boxes;      // por objeto
+    std::vector<uint32_t> Objects;
+    std::vector<uint32_t> LeafOf; // folha que contém cada objeto
+};
+
+#endif
@@ -3,6 +3,9 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Bounds.h"
 
 enum Camera_Movement {
     FORWARD,
@@ -41,6 +44,11 @@ public:
         return glm::lookAt(Position, Position + Front, Up);
     }
 
+    // Planos do volume visível para a projeção dada (espaço do mundo)
+    Frustum GetFrustum(const glm::mat4& projection) {
+        return extractFrustum(projection * GetViewMatrix());
+    }
+
     void ProcessKeyboard(Camera_Movement direction, float deltaTime) {
         float velocity = MovementSpeed * deltaTime;
         if (direction == FORWARD)
@@ -53,6 +61,29 @@ public:
             Position += Right * velocity;
     }
 
+    // Yaw e pitch como quatérnio; a identidade olha para -Z (yaw -90, pitch 0)
+    glm::quat GetOrientation() const {
+        return glm::angleAxis(glm::radians(-(Yaw + 90.0f)), glm::vec3(0.0f, 1.0f, 0.0f)) *
+               glm::angleAxis(glm::radians(Pitch), glm::vec3(1.0f, 0.0f, 0.0f));
+    }
+
+    // Posição e orientação vindas de fora (reprodução de uma gravação)
+    void SetPose(const glm::vec3& position, const glm::quat& orientation) {
+        Position = position;
+        glm::vec3 front = orientation * glm::vec3(0.0f, 0.0f, -1.0f);
+        Pitch = glm::degrees(asin(glm::clamp(front.y, -1.0f, 1.0f)));
+        Yaw = glm::degrees(atan2(front.z, front.x));
+        updateCameraVectors();
+    }
+
+    // Posição e ângulos exatos (percurso gravado com CameraTrack)
+    void SetView(const glm::vec3& position, float yaw, float pitch) {
+        Position = position;
+        Yaw = yaw;
+        Pitch = pitch;
+        updateCameraVectors();
+    }
+
     void ProcessMouseMovement(float xoffset, float yoffset) {
         xoffset *= MouseSensitivity;
         yoffset *= MouseSensitivity;
@@ -0,0 +1,66 @@
+#ifndef CAMERA_TRACK_H
+#define CAMERA_TRACK_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+class Camera;
+
+// Estado da câmera em um quadro
+struct CameraKey {
+    glm::vec3 position = glm::vec3(0.0f);
+    float yaw = -90.0f;
+    float pitch = 0.0f;
+};
+
+// Percurso da câmera gravado quadro a quadro, para repetir exatamente as
+// mesmas vistas (comparação de desempenho entre execuções, regressão visual).
+//
+// Arquivo texto, uma linha por quadro: "x y z yaw pitch"; linhas começando
+// com # são comentários. Os floats são escritos com 9 dígitos significativos,
+// então a leitura devolve os mesmos valores gravados.
+class CameraTrack {
+public:
+    bool load(const std::string& filePath);
+
+    // Quadros além do fim ficam no último registro
+    void apply(Camera& camera, size_t frame) const;
+
+    const CameraKey& key(size_t frame) const;
+    size_t size() const { return Keys.size(); }
+    bool empty() const { return Keys.empty(); }
+    void clear() { Keys.clear(); }
+
+private:
+    std::vector<CameraKey> Keys;
+};
+
+// Gravação incremental: cada quadro é escrito e descarregado (fflush) na hora,
+// então nada se perde se o programa terminar sem chamar close()
+class CameraTrackWriter {
+public:
+    CameraTrackWriter() = default;
+    ~CameraTrackWriter();
+
+    CameraTrackWriter(const CameraTrackWriter&) = delete;
+    CameraTrackWriter& operator=(const CameraTrackWriter&) = delete;
+
+    bool open(const std::string& filePath);
+    void write(const Camera& camera);
+    // Com a posição realmente desenhada (interpolada entre passos)
+    void write(const Camera& camera, const glm::vec3& position);
+    void close();
+
+    bool isOpen() const { return File != nullptr; }
+    size_t framesWritten() const { return Written; }
+
+private:
+    FILE* File = nullptr;
+    size_t Written = 0;
+};
+
+#endif
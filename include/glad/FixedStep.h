@@ -0,0 +1,45 @@
+#ifndef FIXED_STEP_H
+#define FIXED_STEP_H
+
+// Passo fixo de simulação, independente da taxa de quadros.
+//
+// A cada quadro, advance(agora) diz quantos passos de 1/hz segundos devem ser
+// simulados para acompanhar o relógio; o tempo que sobra fica acumulado para o
+// próximo quadro. alpha() é a fração do passo seguinte já decorrida, usada para
+// interpolar entre o estado anterior e o atual na hora de desenhar:
+//
+//   int steps = fixedStep.advance(glfwGetTime());
+//   for (int i = 0; i < steps; ++i) { anterior = atual; simular(fixedStep.step()); }
+//   desenhar(mix(anterior, atual, fixedStep.alpha()));
+//
+// Se o quadro demorar mais que maxSteps passos (janela arrastada, depurador),
+// o atraso é descartado em vez de a simulação tentar alcançá-lo.
+class FixedStep {
+public:
+    explicit FixedStep(double hz = 60.0, int maxSteps = 8);
+
+    void setRate(double hz);
+    double rate() const { return Hz; }
+    float step() const { return (float)Step; }
+
+    int advance(double now);
+    float alpha() const;
+    // Recomeça a contagem a partir do próximo advance()
+    void reset();
+
+    unsigned long long totalSteps() const { return TotalSteps; }
+    // Tempo descartado por excesso de passos em um quadro, em segundos
+    double droppedTime() const { return DroppedTime; }
+
+private:
+    double Hz;
+    double Step;
+    int MaxSteps;
+    double Last = 0.0;
+    double Accumulator = 0.0;
+    bool Started = false;
+    unsigned long long TotalSteps = 0;
+    double DroppedTime = 0.0;
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef FRAME_RECORDER_H
+#define FRAME_RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/glad.h>
+
+enum CaptureFormat {
+    CAPTURE_PNG, // um arquivo por quadro (lento de codificar)
+    CAPTURE_QOI, // um arquivo por quadro, codificação rápida sem perdas
+    CAPTURE_Y4M  // um único vídeo YUV 4:4:4 sem compressão (ffmpeg lê direto)
+};
+
+// Gravação dos quadros desenhados sem parar o pipeline.
+//
+// capture() só agenda um glReadPixels para um pixel pack buffer de um anel
+// (3 por padrão) e coloca uma cerca; o buffer é lido quando a cerca já passou,
+// normalmente dois quadros depois. Os pixels copiados vão para uma thread de
+// escrita, que codifica e grava (PNG/QOI em paralelo no ThreadPool). Se a
+// escrita ficar mais de maxQueued quadros atrás, o quadro é descartado em vez
+// de atrasar o desenho (contado em framesDropped()).
+class FrameRecorder {
+public:
+    FrameRecorder() = default;
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    // outputPath: pasta dos quadros (PNG/QOI) ou arquivo .y4m
+    bool start(const std::string& outputPath, CaptureFormat format, int width, int height,
+               int fps = 60, int ringSize = 3, size_t maxQueued = 8);
+    // Depois de desenhar, antes de trocar os buffers (thread da OpenGL)
+    void capture();
+    // Lê o que falta do anel, espera a escrita e fecha; antes de destruir o contexto
+    void stop();
+
+    bool recording() const { return Recording; }
+    size_t framesWritten() const { return Written; }
+    size_t framesDropped() const { return Dropped; }
+
+private:
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = 0;
+        size_t frame = 0;
+    };
+    struct Frame {
+        size_t index = 0;
+        std::vector<uint8_t> pixels; // RGBA de baixo para cima, como vem da OpenGL
+    };
+
+    void readSlot(Slot& slot);
+    void writerLoop();
+    void writeFrame(Frame& frame);
+
+    bool Recording = false;
+    CaptureFormat Format = CAPTURE_QOI;
+    std::string OutputPath;
+    int Width = 0, Height = 0;
+    size_t FrameBytes = 0;
+    size_t MaxQueued = 8;
+    std::vector<Slot> Ring;
+    size_t NextSlot = 0;
+    size_t Captured = 0;
+    size_t Dropped = 0;
+    std::atomic<size_t> Written{0};
+    double CaptureMs = 0.0;
+    FILE* Video = nullptr;
+
+    std::thread Writer;
+    std::mutex Mutex;
+    std::condition_variable Available;
+    std::deque<Frame> Queue;     // esperando a escrita
+    std::vector<Frame> FreeFrames; // buffers reaproveitados
+    bool Stopping = false;
+};
+
+bool parseCaptureFormat(const std::string& name, CaptureFormat& format);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef GL_EXTRAS_H
+#define GL_EXTRAS_H
+
+#include <glad/glad.h>
+
+// Funções de versões da OpenGL acima da 4.0 gerada na glad. São carregadas à
+// parte (loadGLExtras, logo após gladLoadGLLoader) e ficam nulas quando o
+// driver não as oferece: quem as usa precisa testar o ponteiro e ter um
+// caminho alternativo.
+
+#ifndef GL_VERSION_4_1
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+#endif
+
+#ifndef GL_VERSION_4_3
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+#endif
+
+extern PFNGLGETPROGRAMBINARYPROC glextras_glGetProgramBinary;
+extern PFNGLPROGRAMBINARYPROC glextras_glProgramBinary;
+extern PFNGLPROGRAMPARAMETERIPROC glextras_glProgramParameteri;
+extern PFNGLMULTIDRAWELEMENTSINDIRECTPROC glextras_glMultiDrawElementsIndirect;
+
+#ifndef GL_VERSION_4_1
+#define glGetProgramBinary glextras_glGetProgramBinary
+#define glProgramBinary glextras_glProgramBinary
+#define glProgramParameteri glextras_glProgramParameteri
+#endif
+#ifndef GL_VERSION_4_3
+#define glMultiDrawElementsIndirect glextras_glMultiDrawElementsIndirect
+#endif
+
+// Retorna false se load não encontrar nenhuma das funções
+bool loadGLExtras(GLADloadproc load);
+
+#endif
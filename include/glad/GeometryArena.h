@@ -0,0 +1,92 @@
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "ObjLoader.h"
+
+class InstanceBuffer;
+
+// Malha dentro da arena: faixa de índices + deslocamento dos vértices
+struct ArenaMesh {
+    GLuint firstIndex = 0;
+    GLuint indexCount = 0;
+    GLint baseVertex = 0;
+    MeshBounds bounds;
+};
+
+// Um único VAO com um VBO e um EBO grandes, no layout de OBJ_VERTEX_STRIDE
+// (0 = posição, 1 = uv, 2 = normal), onde as malhas estáticas são alocadas em
+// sequência. Os índices de cada malha são relativos ao seu próprio início
+// (baseVertex), então todas podem sair de uma só vez pelo IndirectBatch, sem
+// trocar de VAO. Quando o espaço acaba os buffers são realocados com o dobro
+// do tamanho (glCopyBufferSubData).
+class GeometryArena {
+public:
+    explicit GeometryArena(size_t vertexCapacity = 1 << 16, size_t indexCapacity = 1 << 18);
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    // vertices com OBJ_VERTEX_STRIDE floats por vértice
+    ArenaMesh add(const GLfloat* vertices, size_t vertexCount, const GLuint* indices, size_t indexCount);
+    ArenaMesh add(const OBJMesh& mesh);
+
+    GLuint vao() const { return VAO; }
+    size_t vertexCount() const { return VertexCount; }
+    size_t indexCount() const { return IndexCount; }
+
+    // Apaga os buffers; chamar antes de destruir o contexto OpenGL
+    void release();
+
+private:
+    void create();
+    void grow(size_t vertices, size_t indices);
+
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    GLuint EBO = 0;
+    size_t VertexCapacity;
+    size_t IndexCapacity;
+    size_t VertexCount = 0;
+    size_t IndexCount = 0;
+};
+
+// Lê o .obj (e o .mtl) e o acrescenta à arena. Retorna false em caso de erro.
+bool loadOBJ(const std::string& filePath, GeometryArena& arena, ArenaMesh& arenaMesh, OBJMaterial* material = nullptr);
+
+// Layout fixo dos comandos lidos de GL_DRAW_INDIRECT_BUFFER
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance; // primeira instância (atributos com divisor); 0 antes da OpenGL 4.2
+};
+
+// Lista de desenhos de um quadro. draw() envia os comandos para um buffer
+// indireto e desenha tudo com um glMultiDrawElementsIndirect (OpenGL 4.3) ou,
+// sem ele, com um glDrawElementsInstancedBaseVertex por comando, ainda sem
+// trocar de VAO. Nesse caso o baseInstance é aplicado movendo os atributos do
+// InstanceBuffer passado em draw() (sem ele, todos começam na instância 0).
+class IndirectBatch {
+public:
+    void clear() { Commands.clear(); }
+    void add(const ArenaMesh& mesh, GLuint instanceCount = 1, GLuint baseInstance = 0);
+    void draw(const GeometryArena& arena, InstanceBuffer* instances = nullptr);
+    void release();
+
+    size_t size() const { return Commands.size(); }
+
+private:
+    std::vector<DrawElementsIndirectCommand> Commands;
+    GLuint Buffer = 0;
+    size_t Capacity = 0;
+};
+
+#endif
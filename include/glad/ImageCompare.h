@@ -0,0 +1,32 @@
+#ifndef IMAGE_COMPARE_H
+#define IMAGE_COMPARE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Imagem RGBA de 8 bits por canal, linhas de cima para baixo
+struct RgbaImage {
+    int width = 0, height = 0;
+    std::vector<uint8_t> pixels;
+};
+
+bool loadPng(const std::string& filePath, RgbaImage& image);
+bool savePng(const std::string& filePath, const RgbaImage& image);
+
+// Comparação de RGB (o alfa é ignorado): um pixel difere se algum canal
+// passa de tolerance. psnr é infinito quando as imagens são idênticas.
+struct ImageDiff {
+    size_t differentPixels = 0;
+    int maxDifference = 0;
+    double psnr = 0.0;
+};
+
+// As duas imagens precisam ter o mesmo tamanho
+ImageDiff compareImages(const RgbaImage& a, const RgbaImage& b, int tolerance);
+
+// Pixels acima da tolerância em vermelho sobre a referência a em cinza escuro
+RgbaImage diffImage(const RgbaImage& a, const RgbaImage& b, int tolerance);
+
+#endif
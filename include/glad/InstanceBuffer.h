@@ -0,0 +1,49 @@
+#ifndef INSTANCE_BUFFER_H
+#define INSTANCE_BUFFER_H
+
+#include <cstddef>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Dados de uma cópia (instância) de uma malha desenhada com glDraw*Instanced
+struct InstanceData {
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec3 color = glm::vec3(1.0f);
+    float selected = 0.0f; // 1 se o objeto estiver selecionado
+};
+
+// Primeiro atributo de vértice usado pelas instâncias: model ocupa
+// INSTANCE_ATTRIB .. INSTANCE_ATTRIB + 3 e (color, selected) o seguinte.
+// No shader:
+//   layout (location = 3) in mat4 instanceModel;
+//   layout (location = 7) in vec4 instanceColor; // rgb + selected
+const GLuint INSTANCE_ATTRIB = 3;
+
+// VBO com um InstanceData por cópia (glVertexAttribDivisor = 1): todas as
+// cópias de uma malha saem em uma única chamada de desenho.
+class InstanceBuffer {
+public:
+    // Liga o buffer aos atributos INSTANCE_ATTRIB.. do VAO (criando-o na primeira vez)
+    void attach(GLuint VAO);
+    // Com o VAO vinculado: a instância 0 do próximo desenho passa a ser a de
+    // índice first (faz o papel do baseInstance, que só existe na OpenGL 4.2+)
+    void setFirstInstance(size_t first);
+    // Substitui o conteúdo; realoca (órfão) quando count passa da capacidade
+    void update(const InstanceData* data, size_t count);
+    // Para escrever as instâncias direto no buffer, sem cópia intermediária:
+    // órfão + glMapBufferRange só de escrita. Entre map e unmap não há outras
+    // chamadas da OpenGL sobre o buffer; nullptr se count == 0 ou o mapeamento falhar.
+    InstanceData* map(size_t count);
+    void unmap();
+    void release();
+
+    GLsizei count() const { return (GLsizei)Count; }
+
+private:
+    GLuint Buffer = 0;
+    size_t Count = 0;
+    size_t Capacity = 0;
+};
+
+#endif
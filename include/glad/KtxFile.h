@@ -0,0 +1,51 @@
+#ifndef KTX_FILE_H
+#define KTX_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Formatos S3TC (GL_EXT_texture_compression_s3tc): não fazem parte do núcleo
+// e não estão na glad gerada para o projeto
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+// Textura no formato KTX 1.1 (https://registry.khronos.org/KTX/specs/1.0/ktxspec.v1.html)
+// gerada pelo TexBake: uma face, sem array, com a cadeia de mipmaps já calculada.
+struct KtxLevel {
+    int width = 0;
+    int height = 0;
+    size_t offset = 0; // em data
+    size_t size = 0;
+};
+
+struct KtxImage {
+    GLenum internalFormat = 0;
+    GLenum format = 0;       // 0 se comprimido
+    GLenum type = 0;         // 0 se comprimido
+    GLenum baseFormat = 0;   // GL_RGB ou GL_RGBA
+    std::vector<KtxLevel> levels;
+    std::vector<unsigned char> data;
+
+    bool compressed() const { return type == 0; }
+    // Soma dos níveis: o que a textura ocupa na GPU
+    size_t levelBytes() const;
+};
+
+// Lê o arquivo inteiro. Retorna false se não for um KTX 1.1 2D suportado.
+bool readKTX(const std::string& filePath, KtxImage& image);
+// Só o cabeçalho e o tamanho dos níveis (data fica vazio)
+bool readKTXInfo(const std::string& filePath, KtxImage& image);
+bool writeKTX(const std::string& filePath, const KtxImage& image);
+
+// Versão pré-processada de uma imagem (pixelWall.png -> pixelWall.ktx), se
+// existir e não for mais antiga que o original; vazio caso contrário.
+std::string bakedTexturePath(const std::string& imagePath);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Arquivo mapeado em memória (somente leitura).
+// Evita copiar o conteúdo para buffers intermediários: os parsers percorrem
+// os bytes diretamente a partir de data().
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Retorna false se o arquivo não existir ou não puder ser mapeado.
+    // Arquivos vazios abrem com sucesso e size() == 0.
+    bool open(const std::string& filePath);
+    void close();
+
+    const char* data() const { return Data; }
+    size_t size() const { return Size; }
+    bool isOpen() const { return Opened; }
+
+private:
+    const char* Data = nullptr;
+    size_t Size = 0;
+    bool Opened = false;
+#ifdef _WIN32
+    void* FileHandle = nullptr;
+    void* MappingHandle = nullptr;
+#endif
+};
+
+#endif
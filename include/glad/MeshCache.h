@@ -0,0 +1,71 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+#include "ObjLoader.h"
+
+// Cache binário de malhas já processadas, gravado ao lado do .obj
+// (Suzanne.obj -> Suzanne.obj.meshbin). Na próxima execução o arquivo é mapeado
+// em memória e os blocos de vértices/índices vão direto para glBufferData,
+// sem reler o texto do .obj e do .mtl.
+//
+// Layout (little-endian, offsets a partir do início do arquivo):
+//   MeshCacheHeader
+//   MeshCacheAttribute[attributeCount]
+//   tabela de material: mtlFile, mapKd (uint32 tamanho + bytes), ka, kd, ks, ns
+//   bloco de vértices (alinhado em 16 bytes)
+//   bloco de índices (uint16 ou uint32, alinhado em 16 bytes)
+
+const uint32_t MESH_CACHE_MAGIC = 0x4853454D; // "MESH"
+const uint32_t MESH_CACHE_VERSION = 2;
+
+struct MeshCacheAttribute {
+    uint32_t location;
+    uint32_t components; // floats
+    uint32_t offset;     // em bytes, dentro do vértice
+};
+
+struct MeshCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+
+    // Identificação do .obj de origem: tamanho + data de modificação são
+    // conferidos primeiro; se diferirem, o hash do conteúdo decide e, se ele
+    // bater, a data nova é gravada aqui.
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceHash;
+    // Mesmo controle (sem hash) para o .mtl, se houver
+    uint64_t mtlSize;
+    int64_t mtlMtime;
+
+    uint32_t vertexStride; // em bytes
+    uint32_t attributeCount;
+    uint32_t nVertices;
+    uint32_t nIndices;
+    uint32_t indexSize;    // 2 ou 4 bytes
+    uint32_t hasMaterial;
+
+    uint64_t materialOffset;
+    uint64_t vertexOffset;
+    uint64_t vertexBytes;
+    uint64_t indexOffset;
+    uint64_t indexBytes;
+};
+
+std::string meshCachePath(const std::string& objPath);
+
+// Grava o cache da malha já lida de objPath. Falhas (diretório sem permissão
+// de escrita, por exemplo) não são fatais: retorna false e a malha segue em memória.
+bool writeMeshCache(const std::string& objPath, const OBJMesh& mesh);
+
+// Carrega a malha do cache se ele existir, corresponder ao .obj atual e todos
+// os índices apontarem para vértices existentes.
+bool loadMeshCache(const std::string& objPath, GLMesh& glMesh, OBJMaterial* material = nullptr);
+
+// Hash de 64 bits do conteúdo (usado para validar o cache)
+uint64_t hashBytes(const void* data, size_t size);
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef OBJ_LOADER_H
+#define OBJ_LOADER_H
+
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "Bounds.h"
+
+// Leitor compartilhado de arquivos Wavefront .OBJ/.MTL usado por todos os exercícios.
+// O arquivo é mapeado em memória e percorrido por um tokenizador próprio
+// (std::from_chars), sem std::istringstream nem alocação por linha.
+
+// Número de floats por vértice no buffer gerado: posição (3) + uv (2) + normal (3)
+const int OBJ_VERTEX_STRIDE = 8;
+
+struct OBJMaterial {
+    std::string mapKd; // textura difusa (map_Kd), vazio se não houver
+    float ka = 0.1f;
+    float kd = 0.7f;
+    float ks = 0.2f;
+    float ns = 10.0f;
+};
+
+struct OBJMesh {
+    std::vector<GLfloat> vBuffer; // vértices únicos, OBJ_VERTEX_STRIDE floats cada
+    std::vector<GLuint> indices;  // 3 índices por triângulo
+    int nVertices = 0;            // número de vértices únicos
+    int nIndices = 0;
+    std::string mtlFile;          // caminho do mtllib, como escrito no .obj
+    MeshBounds bounds;            // AABB e esfera das posições
+    bool hasMaterial = false;     // true se o .mtl foi encontrado e lido
+    OBJMaterial material;
+};
+
+// Malha já enviada para a GPU (VAO com GL_ELEMENT_ARRAY_BUFFER)
+struct GLMesh {
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    GLuint EBO = 0;
+    GLsizei nIndices = 0;
+    GLenum indexType = GL_UNSIGNED_INT; // GL_UNSIGNED_SHORT se couber em 16 bits
+    MeshBounds bounds;                  // calculado no envio (também vindo do cache)
+};
+
+class ThreadPool;
+
+// Lê o .obj (e o .mtl referenciado) para a memória, sem tocar na OpenGL.
+// Vértices com a mesma combinação v/vt/vn são armazenados uma única vez.
+// Faces com mais de 3 vértices são triangularizadas em leque; índices negativos
+// (relativos ao fim da lista) e faces v, v/vt e v//vn são aceitos. Cantos sem
+// normal recebem a média das normais das faces vizinhas (suave) ou, com
+// flatNormals, a normal do próprio triângulo.
+// Arquivos grandes são divididos em trechos (em quebras de linha) lidos em
+// paralelo pelo pool (ThreadPool::shared() se pool == nullptr); o resultado é
+// idêntico ao da leitura sequencial. Retorna false se o arquivo não puder ser aberto.
+bool parseOBJ(const std::string& filePath, OBJMesh& mesh, ThreadPool* pool = nullptr, bool flatNormals = false);
+
+// Lê um .mtl. Campos ausentes mantêm os valores já presentes em material.
+bool parseMTL(const std::string& filePath, OBJMaterial& material);
+
+// Cria VBO + EBO + VAO com os atributos 0 = posição, 1 = uv, 2 = normal.
+// Os índices usam 16 bits quando a malha tem até 65535 vértices.
+GLMesh uploadOBJ(const OBJMesh& mesh);
+
+// Cria os buffers a partir de dados já no formato final (usado pelo cache binário).
+// vertexData deve seguir o layout de OBJ_VERTEX_STRIDE.
+GLMesh uploadMesh(const void* vertexData, size_t vertexBytes, const void* indexData, size_t indexBytes,
+                  GLenum indexType, GLsizei nIndices);
+
+// Lê e envia para a GPU. Retorna false em caso de erro. Se material != nullptr
+// e o .mtl existir, seus valores são copiados para lá.
+// Usa o cache binário (MeshCache.h) quando ele estiver atualizado e o cria caso contrário.
+bool loadOBJ(const std::string& filePath, GLMesh& glMesh, OBJMaterial* material = nullptr);
+
+// glDrawElements com o VAO da malha
+void drawMesh(const GLMesh& glMesh);
+
+// Desenha instanceCount cópias da malha (atributos por instância já ligados ao VAO)
+void drawMeshInstanced(const GLMesh& glMesh, GLsizei instanceCount);
+
+void deleteMesh(GLMesh& glMesh);
+
+// Compatibilidade com as antigas versões locais: retorna um VAO sem índices
+// (para glDrawArrays) ou -1 em caso de erro.
+int loadSimpleOBJ(const std::string& filePath, int& nVertices, OBJMaterial* material = nullptr);
+
+#endif
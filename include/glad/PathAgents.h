@@ -0,0 +1,71 @@
+#ifndef PATH_AGENTS_H
+#define PATH_AGENTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "InstanceBuffer.h"
+
+class SplinePath;
+class ThreadPool;
+
+// Muitos objetos andando pelo mesmo caminho, cada um com a sua distância e
+// velocidade, guardados como estrutura de arrays.
+//
+// Em vez de buscar a distância na tabela do caminho a cada passo, cada agente
+// lembra o trecho da tabela em que está, quanto já andou dentro dele e a
+// cúbica que converte essa distância em t (SplinePath::intervalInverse). Um
+// passo é então soma, comparação e dois polinômios, quatro agentes por vez com
+// SSE2; só quem sai do trecho (a cada ~10 passos) vai para o caminho escalar.
+//
+// As velocidades são em unidades por segundo e não negativas. Em caminho
+// aberto o agente para no fim. Se o caminho for refeito, os agentes precisam
+// ser recriados (os índices dos trechos mudam).
+class PathAgents {
+public:
+    // O caminho precisa existir enquanto os agentes forem usados
+    void setPath(const SplinePath* path);
+
+    // Retorna o índice do novo agente (posição já calculada)
+    size_t add(double distance, float speed);
+    void reserve(size_t count);
+    void clear();
+    size_t size() const { return Speed.size(); }
+
+    float speed(size_t i) const { return Speed[i]; }
+    void setSpeed(size_t i, float speed);
+    double distance(size_t i) const;
+    glm::vec3 position(size_t i) const { return glm::vec3(PosX[i], PosY[i], PosZ[i]); }
+
+    // Anda dt segundos e recalcula as posições; com pool, divide os agentes
+    // entre as threads (sem pool, tudo na thread que chama)
+    void update(float dt, ThreadPool* pool = nullptr);
+
+    // model = translate(posição) * scale(escala) de cada agente, escrito em
+    // sequência em out (pode ser a memória mapeada de um InstanceBuffer). A
+    // posição é a do passo anterior misturada com a atual por alpha
+    // (FixedStep::alpha()); com 1, a do último passo.
+    void writeInstances(InstanceData* out, float scale, const glm::vec3& color = glm::vec3(1.0f),
+                        ThreadPool* pool = nullptr, float alpha = 1.0f) const;
+
+private:
+    void updateRange(size_t begin, size_t end, float dt);
+    // Leva o agente para o trecho em que Offset cabe e refaz a cúbica
+    void nextInterval(size_t i);
+    void evaluate(size_t i);
+
+    const SplinePath* Path = nullptr;
+
+    std::vector<uint32_t> Interval; // trecho da tabela do caminho
+    std::vector<float> Offset;      // distância andada dentro do trecho
+    std::vector<float> Length;      // comprimento do trecho
+    std::vector<float> C0, C1, C2, C3; // t(Offset), ver SplinePath::intervalInverse
+    std::vector<float> Speed;
+    std::vector<float> PosX, PosY, PosZ;
+    std::vector<float> PrevX, PrevY, PrevZ; // antes do último update()
+};
+
+#endif
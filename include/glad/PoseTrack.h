@@ -0,0 +1,85 @@
+#ifndef POSE_TRACK_H
+#define POSE_TRACK_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+struct Pose {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+};
+
+// Poses com tempo (quadros-chave). Entre dois quadros, a posição é
+// interpolada linearmente e a orientação por slerp, sempre em função do
+// tempo: sample(t) é uma busca binária mais uma interpolação, e com o cursor
+// de quem reproduz em ordem nem a busca acontece.
+class PoseTrack {
+public:
+    void clear();
+    // Tempos em ordem crescente (um tempo menor que o último é ignorado)
+    void addKey(double time, const Pose& pose);
+
+    size_t size() const { return Times.size(); }
+    bool empty() const { return Times.empty(); }
+    double startTime() const { return Times.empty() ? 0.0 : Times.front(); }
+    double endTime() const { return Times.empty() ? 0.0 : Times.back(); }
+    double duration() const { return endTime() - startTime(); }
+
+    double time(size_t i) const { return Times[i]; }
+    Pose key(size_t i) const { return {Positions[i], Orientations[i]}; }
+
+    // Pose no tempo dado (a primeira antes do início, a última depois do fim)
+    Pose sample(double time) const;
+    // Mesmo resultado; cursor guarda o quadro usado e é testado antes da busca
+    Pose sample(double time, size_t& cursor) const;
+
+private:
+    Pose interpolate(size_t i, double time) const;
+
+    std::vector<double> Times;
+    std::vector<glm::vec3> Positions;
+    std::vector<glm::quat> Orientations;
+};
+
+// Amostra poses a uma taxa fixa e as reduz a quadros-chave com erro limitado:
+// Ramer-Douglas-Peucker no tempo, em que a pose de cada amostra é comparada
+// com a interpolação (posição linear, orientação por slerp) entre os quadros
+// que ficam. A redução é feita em janelas de `window` amostras, então só uma
+// janela de amostras brutas fica na memória mesmo em gravações de horas.
+class PoseRecorder {
+public:
+    // positionTolerance em unidades do mundo, angleTolerance em graus
+    void start(double rate = 60.0, float positionTolerance = 0.005f, float angleTolerance = 0.25f,
+               size_t window = 4096);
+    // Chamado a cada passo da simulação; grava uma amostra a cada 1/rate s
+    void sample(double time, const Pose& pose);
+    // Reduz a janela que falta e devolve a trilha completa
+    const PoseTrack& finish();
+
+    const PoseTrack& track() const { return Track; }
+    size_t samplesRecorded() const { return Samples; }
+
+private:
+    // Reduz Raw; com last, também grava a última amostra (senão ela abre a próxima janela)
+    void reduce(bool last);
+
+    PoseTrack Track;
+    std::vector<double> RawTimes;
+    std::vector<Pose> Raw;
+    double Period = 1.0 / 60.0;
+    double NextSample = 0.0;
+    float PositionTolerance = 0.005f;
+    float AngleTolerance = 0.0f; // em radianos
+    size_t Window = 4096;
+    size_t Samples = 0;
+};
+
+// Várias trilhas em um arquivo binário (.pose)
+bool savePoseTracks(const std::string& filePath, const std::vector<PoseTrack>& tracks);
+bool loadPoseTracks(const std::string& filePath, std::vector<PoseTrack>& tracks);
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+// Medição de tempo por quadro.
+//
+// Zonas de CPU (PROFILE_ZONE) medem o escopo com steady_clock e gravam num anel
+// próprio de cada thread, sem trava. Zonas de GPU (GpuProfileScope) usam um par
+// de consultas GL_TIME_ELAPSED; os resultados são lidos dois quadros depois
+// (consultas em buffer duplo), quando já estão prontos, para não parar a CPU
+// esperando a GPU. Zonas de GPU não podem se aninhar (limitação da OpenGL).
+//
+// endFrame() junta as zonas do quadro; printStats() mostra mínimo, média e
+// percentil 99 dos últimos quadros e writeChromeTrace() grava os eventos no
+// formato JSON do chrome://tracing (ou ui.perfetto.dev).
+class Profiler {
+public:
+    static Profiler& shared();
+
+    // Desligado, as zonas não gravam nada (custo de um teste por escopo)
+    void setEnabled(bool enabled);
+    bool enabled() const;
+
+    // Chamados na thread da OpenGL, no início e no fim de cada quadro
+    void beginFrame();
+    void endFrame();
+
+    // false (e nada a fechar) se desligado ou se já há uma zona de GPU aberta
+    bool beginGpu(const char* name);
+    void endGpu();
+
+    // Também na thread da OpenGL
+    void printStats(std::ostream& out) const;
+    bool writeChromeTrace(const std::string& filePath) const;
+
+    // Apaga as consultas de GPU; antes de destruir o contexto OpenGL
+    void release();
+
+    // Nanossegundos desde o início do programa
+    static uint64_t now();
+    // name precisa viver até o fim do programa (um literal)
+    static void recordCpu(const char* name, uint64_t start, uint64_t end);
+
+private:
+    struct TraceEvent {
+        const char* name;
+        uint32_t thread;
+        uint64_t start, duration;
+    };
+    struct ZoneStats {
+        std::vector<float> cpuMs, gpuMs; // anéis de HISTORY_FRAMES
+        size_t cpuNext = 0, gpuNext = 0;
+    };
+    struct GpuQuery {
+        GLuint query = 0;
+        const char* name = nullptr;
+        uint64_t cpuStart = 0;
+    };
+    struct GpuFrame {
+        std::vector<GpuQuery> queries;
+        size_t used = 0;
+    };
+    struct ThreadEvents;
+
+    Profiler() = default;
+    void harvestGpu(GpuFrame& frame);
+    void pushTrace(const TraceEvent& event);
+    static void pushSample(std::vector<float>& history, size_t& next, float value);
+
+    std::vector<std::shared_ptr<ThreadEvents>> Threads; // sob ThreadsMutex
+    mutable std::mutex ThreadsMutex;
+
+    std::map<std::string, ZoneStats> Zones;
+    std::vector<TraceEvent> Trace;
+    size_t DroppedEvents = 0;
+    GpuFrame GpuFrames[2];
+    int CurrentGpuFrame = 0;
+    bool GpuOpen = false;
+    uint64_t FrameStart = 0;
+    uint64_t Frames = 0;
+};
+
+// Zona de CPU do escopo atual
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* Name;
+    uint64_t Start;
+};
+
+// Zona de GPU do escopo atual (thread da OpenGL)
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char* name);
+    ~GpuProfileScope();
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    bool Active;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileScope PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_GPU_ZONE(name) GpuProfileScope PROFILE_CONCAT(profileGpuZone, __LINE__)(name)
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <glad/glad.h>
+
+// Diretório (relativo ao diretório atual) dos binários
+const char* const SHADER_CACHE_DIR = "shadercache";
+
+// Compila e liga um programa de vertex + fragment shader, guardando o binário
+// do driver (glGetProgramBinary) em SHADER_CACHE_DIR. Nas execuções seguintes,
+// com os mesmos fontes e o mesmo driver (fabricante, renderer e versão), o
+// programa é restaurado com glProgramBinary sem recompilar. Se o driver
+// recusar o binário, ou não oferecer as funções da OpenGL 4.1 (loadGLExtras),
+// compila normalmente. O tempo de cada caminho é mostrado no console.
+//
+// Erros de compilação/ligação são mostrados como nos antigos setupShader;
+// o programa é retornado mesmo assim.
+GLuint createShaderProgram(const GLchar* vertexSource, const GLchar* fragmentSource);
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef SHADER_PROGRAM_H
+#define SHADER_PROGRAM_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Programa de shader já ligado, com a lista de uniforms ativos lida uma única
+// vez (glGetActiveUniform). location() consulta essa tabela em memória: os
+// exercícios guardam as localizações antes do loop e não chamam
+// glGetUniformLocation a cada quadro.
+struct UniformInfo {
+    std::string name; // arrays sem o sufixo "[0]"
+    GLint location = -1;
+    GLenum type = 0;
+    GLint size = 0;
+};
+
+class ShaderProgram {
+public:
+    ShaderProgram() = default;
+    explicit ShaderProgram(GLuint program);
+
+    GLuint id() const { return Program; }
+    void use() const { glUseProgram(Program); }
+
+    // -1 se o uniform não existir (ou tiver sido descartado pelo compilador)
+    GLint location(const std::string& name) const;
+    const std::vector<UniformInfo>& uniforms() const { return Uniforms; }
+
+    // Liga o bloco uniform blockName ao ponto de ligação binding.
+    // Retorna false se o programa não tiver esse bloco.
+    bool bindUniformBlock(const char* blockName, GLuint binding) const;
+
+private:
+    GLuint Program = 0;
+    std::vector<UniformInfo> Uniforms; // ordenado por nome
+};
+
+// Dados por quadro (câmera e luz), no layout std140 do bloco FrameData:
+//
+//   layout (std140) uniform FrameData {
+//       mat4 projection;
+//       mat4 view;
+//       vec4 lightPos;  // xyz
+//       vec4 camPos;    // xyz
+//       float ka;
+//       float kd;
+//       float ks;
+//       float q;
+//   };
+const GLuint FRAME_UNIFORMS_BINDING = 0;
+
+struct FrameUniforms {
+    glm::mat4 projection = glm::mat4(1.0f);
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::vec4 lightPos = glm::vec4(0.0f);
+    glm::vec4 camPos = glm::vec4(0.0f);
+    float ka = 0.1f;
+    float kd = 0.7f;
+    float ks = 0.2f;
+    float q = 10.0f;
+};
+static_assert(sizeof(FrameUniforms) == 176, "FrameUniforms precisa seguir o layout std140");
+
+// Uniform buffer object ligado a um ponto fixo, atualizado com glBufferSubData
+class UniformBuffer {
+public:
+    void create(size_t size, GLuint binding);
+    void update(const void* data, size_t size);
+    void release();
+
+    GLuint id() const { return Buffer; }
+
+private:
+    GLuint Buffer = 0;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef SPLINE_PATH_H
+#define SPLINE_PATH_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+enum SplineType {
+    SPLINE_LINEAR,      // segmentos retos entre os pontos
+    SPLINE_CATMULL_ROM, // passa por todos os pontos (centrípeta, sem laços nas curvas fechadas)
+    SPLINE_BEZIER       // cúbicas p0 c1 c2 p1 c3 c4 p2 ...: só os pontos 0, 3, 6... são atingidos
+};
+
+// Caminho contínuo pelos pontos de controle, percorrido por distância.
+//
+// build() converte cada segmento em um polinômio cúbico e monta a tabela de
+// comprimento de arco: o segmento é dividido em samplesPerSegment trechos, cada
+// um integrado com Gauss-Legendre de 5 pontos. position(d) é então uma busca
+// binária pelo segmento, outra pelo trecho e a avaliação do polinômio, sem
+// raízes nem divisões por comprimento no laço; andar à mesma velocidade é só
+// somar velocidade * dt à distância.
+//
+// O início de cada segmento fica em double, para que caminhos longos (100k+
+// pontos) não percam precisão; dentro do segmento as distâncias são float.
+class SplinePath {
+public:
+    // Retorna false (caminho vazio) se não houver pontos suficientes para o tipo
+    bool build(const std::vector<glm::vec3>& points, SplineType type, bool closed,
+               int samplesPerSegment = 8);
+    void clear();
+
+    bool empty() const { return Segments.empty(); }
+    size_t segmentCount() const { return Segments.size(); }
+    double length() const { return SegmentStart.empty() ? 0.0 : SegmentStart.back(); }
+    bool closed() const { return Closed; }
+
+    // Distância levada para dentro do caminho: dá a volta se fechado, senão satura
+    double wrap(double distance) const;
+
+    glm::vec3 position(double distance) const;
+    // Direção do movimento (normalizada) na distância dada
+    glm::vec3 direction(double distance) const;
+
+    // Segmento e parâmetro t (0-1) do polinômio na distância dada
+    void locate(double distance, size_t& segment, float& t) const;
+    glm::vec3 segmentPoint(size_t segment, float t) const;
+    // a, b, c, d do segmento em 12 floats seguidos (p(t) = ((a t + b) t + c) t + d)
+    const float* segmentCoefficients(size_t segment) const { return &Segments[segment].a.x; }
+
+    // Trechos da tabela, numerados segmento * samplesPerSegment() + k. Quem
+    // anda aos poucos (PathAgents) passa de um trecho para o seguinte sem
+    // buscar de novo e converte distância em t pela cúbica de intervalInverse.
+    int samplesPerSegment() const { return Samples; }
+    size_t intervalCount() const { return SampleLength.size(); }
+    float intervalLength(size_t interval) const;
+    double intervalStart(size_t interval) const;
+    // Trecho que contém a distância e quanto dela fica dentro do trecho
+    void locateInterval(double distance, size_t& interval, float& offset) const;
+    // t(u) = ((c[3] u + c[2]) u + c[1]) u + c[0] para 0 <= u <= intervalLength:
+    // Hermite monotônica com as derivadas dt/du = 1/|p'(t)| nas pontas do trecho
+    void intervalInverse(size_t interval, float c[4]) const;
+
+private:
+    // p(t) = ((a t + b) t + c) t + d
+    struct Cubic {
+        glm::vec3 a, b, c, d;
+    };
+    static_assert(sizeof(Cubic) == 12 * sizeof(float), "Cubic precisa ser 12 floats seguidos");
+
+    void addSegment(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d);
+    void buildLengthTable();
+
+    std::vector<Cubic> Segments;
+    std::vector<double> SegmentStart; // distância no início de cada segmento; a última é o total
+    std::vector<float> SampleLength;  // por segmento, distância acumulada no fim de cada trecho
+    int Samples = 8;
+    bool Closed = false;
+};
+
+bool parseSplineType(const std::string& name, SplineType& type);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include <glad/glad.h>
+
+class TextureStreamer;
+
+// Registro de texturas compartilhado entre objetos. A chave é o conteúdo do
+// arquivo (hash), resolvido a partir do caminho canônico: o mesmo PNG pedido
+// por vários objetos, ou copiado com outro nome, é decodificado e enviado para
+// a GPU uma única vez. Cada acquire() soma uma referência; texturas sem
+// referências continuam na GPU para reuso e só são apagadas (da menos
+// recentemente usada para a mais) quando a estimativa de memória passa do orçamento.
+class TextureCache {
+public:
+    explicit TextureCache(TextureStreamer& streamer, size_t vramBudget = 256u << 20);
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // Nome da textura para filePath (carregada pelo streamer se for nova)
+    GLuint acquire(const std::string& filePath);
+    void release(GLuint texID);
+
+    void setBudget(size_t bytes);
+    // Apaga todas as texturas; chamar antes de destruir o contexto OpenGL
+    void clear();
+
+    size_t vramBytes() const { return VramBytes; }
+    size_t hits() const { return Hits; }
+    size_t misses() const { return Misses; }
+    size_t evictions() const { return Evictions; }
+    void printStats() const;
+
+private:
+    struct Entry {
+        GLuint texID = 0;
+        int refCount = 0;
+        size_t bytes = 0;
+        std::list<uint64_t>::iterator lru; // válido só com refCount == 0
+    };
+    struct PathInfo {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t key = 0;
+        size_t bytes = 0; // estimativa na GPU, reaproveitada se a textura voltar depois de descartada
+    };
+
+    void evictToBudget();
+
+    TextureStreamer& Streamer;
+    size_t Budget;
+    size_t VramBytes = 0;
+    size_t Hits = 0;
+    size_t Misses = 0;
+    size_t Evictions = 0;
+    std::unordered_map<uint64_t, Entry> Entries;      // hash do conteúdo -> textura
+    std::unordered_map<std::string, PathInfo> Paths;  // caminho canônico -> hash
+    std::unordered_map<GLuint, uint64_t> Keys;        // textura -> hash
+    std::list<uint64_t> Unused;                       // sem referências, mais recente na frente
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <glad/glad.h>
+
+class ThreadPool;
+
+// Carregamento assíncrono de texturas. request() devolve na hora um nome de
+// textura válido, preenchido com uma imagem provisória (xadrez cinza 2x2); a
+// decodificação (stb_image) acontece nas threads do pool e update(), chamado
+// uma vez por quadro na thread da OpenGL, envia os pixels já decodificados por
+// um anel de pixel unpack buffers, em faixas de linhas, até o orçamento de
+// bytes do quadro. As faixas vão para uma textura à parte; só quando a última
+// chega o mesmo nome passa a ter o conteúdo real (e mipmaps), sem o chamador
+// trocar de textura e sem nenhum quadro amostrar a imagem pela metade.
+// Se houver um .ktx atualizado ao lado da imagem (gerado pelo TexBake), ele é
+// usado no lugar: mipmaps prontos e, com S3TC, 4 a 8 vezes menos memória. Os
+// níveis sobem pelo mesmo anel e orçamento, um por vez, do menor para o maior.
+class TextureStreamer {
+public:
+    // ringSize PBOs de slotBytes cada (crescem se uma linha não couber)
+    explicit TextureStreamer(ThreadPool* pool = nullptr, int ringSize = 3, size_t slotBytes = 1 << 20);
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Cria a textura com a imagem provisória e agenda a decodificação.
+    GLuint request(const std::string& filePath);
+
+    // Envia até budgetBytes de pixels decodificados para a GPU. Só avança
+    // sobre um PBO cuja cópia anterior já terminou (glClientWaitSync sem espera).
+    void update(size_t budgetBytes = 4 << 20);
+
+    // Chama update() até todas as texturas pedidas estarem prontas (ou falharem).
+    void finish();
+
+    // Libera os PBOs e cercas (não as texturas, que continuam do chamador) e
+    // esquece os pedidos ainda pendentes, que ficam com a imagem provisória.
+    // Deve ser chamado antes de destruir o contexto OpenGL; o destrutor chama de novo.
+    void release();
+
+    // Desiste de uma textura ainda pendente, antes de o chamador apagá-la: o
+    // que já foi decodificado para ela é descartado, e um novo pedido que
+    // receba o mesmo nome da OpenGL não recebe os pixels do antigo.
+    void cancel(GLuint texID);
+
+    // Se as versões .ktx com S3TC podem ser usadas (consulta na thread da OpenGL)
+    bool compressedSupported();
+
+    bool isReady(GLuint texID) const;
+    // true enquanto a textura ainda espera decodificação ou envio
+    bool isPending(GLuint texID) const;
+    // Texturas ainda sem o conteúdo real (decodificando ou subindo)
+    size_t pending() const { return Pending; }
+
+private:
+    struct Decoded;
+    struct Shared;
+    struct Slot {
+        GLuint pbo = 0;
+        size_t size = 0;
+        GLsync fence = 0;
+    };
+    struct Upload {
+        std::unique_ptr<Decoded> image;
+        GLuint staging = 0; // recebe as faixas até a imagem ficar completa
+        int rowsDone = 0;
+        int levelsDone = 0; // .ktx: níveis já enviados, do menor para o maior
+    };
+
+    bool startNextUpload();
+    void commitStaging(const Decoded& image);
+    bool uploadBakedLevel(size_t& budgetBytes);
+    // Próximo PBO do anel, vinculado e mapeado para bytes (dst nullptr se o
+    // driver não mapear); false se a GPU ainda o estiver lendo
+    bool mapSlot(size_t bytes, unsigned char*& dst);
+    void submitSlot(bool mapped);
+
+    ThreadPool* Pool;
+    std::shared_ptr<Shared> State; // compartilhado com as tarefas de decodificação
+    std::vector<Slot> Ring;
+    size_t NextSlot = 0;
+    size_t SlotBytes;
+    Upload Current;
+    GLuint CopyFramebuffers[2] = {0, 0}; // leitura (faixas) e escrita (textura do chamador)
+    size_t Pending = 0;
+    int S3tcSupported = -1; // consultado no primeiro uso, na thread da OpenGL
+    std::unordered_map<GLuint, bool> Ready;
+    std::unordered_map<GLuint, uint64_t> Requests; // pendentes: textura -> número do pedido
+    uint64_t NextRequest = 0;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Conjunto fixo de threads de trabalho, compartilhado pelos carregadores
+// (OBJ, texturas) e pelas simulações que dividem trabalho entre núcleos.
+class ThreadPool {
+public:
+    // workerCount threads além da thread que chama parallelFor
+    explicit ThreadPool(unsigned workerCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Número de threads que participam de parallelFor (workers + chamador)
+    unsigned concurrency() const { return (unsigned)Workers.size() + 1; }
+
+    // Executa task em alguma thread de trabalho, sem esperar
+    void submit(std::function<void()> task);
+
+    // Divide [0, count) em blocos e chama fn(begin, end) para cada um, usando
+    // os workers e a própria thread chamadora. Retorna quando todos terminam.
+    // Pode ser chamado de dentro de uma tarefa do próprio pool.
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)>& fn, size_t minBlockSize = 1);
+
+    // Pool global com hardware_concurrency() - 1 workers
+    static ThreadPool& shared();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> Workers;
+    std::deque<std::function<void()>> Tasks;
+    std::mutex Mutex;
+    std::condition_variable Available;
+    bool Stopping = false;
+};
+
+#endif
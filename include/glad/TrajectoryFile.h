@@ -0,0 +1,111 @@
+#ifndef TRAJECTORY_FILE_H
+#define TRAJECTORY_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "MappedFile.h"
+
+// Trajetória em formato binário (.traj), lida direto do arquivo mapeado.
+//
+//   cabeçalho (32 bytes): "TRAJBIN\0", versão, flags, pontos por bloco
+//   blocos, um atrás do outro, todos com chunkPoints pontos menos o último:
+//     cabeçalho do bloco (40 bytes): pontos, duração, tempo inicial (double),
+//                                     caixa mínima e máxima dos pontos
+//     posições: float32 xyz ou, com TRAJECTORY_QUANTIZED, int16 xyz
+//               relativos à caixa do bloco (erro <= tamanho da caixa / 65535);
+//               o bloco incompleto do fim fica sempre em float32, então
+//               reabrir e acrescentar não acumula erro de quantização
+//     tempos (TRAJECTORY_TIMESTAMPS): float32, segundos desde o tempo inicial
+//
+// Como os blocos cheios têm todos o mesmo tamanho, o bloco i começa em
+// 32 + i * tamanho: o índice dos blocos é implícito e nunca precisa ser
+// regravado. Só o último bloco, ainda incompleto, é reescrito ao acrescentar.
+enum TrajectoryFlags {
+    TRAJECTORY_TIMESTAMPS = 1,
+    TRAJECTORY_QUANTIZED = 2
+};
+
+class TrajectoryReader {
+public:
+    // Retorna false se o arquivo não existir ou não for uma trajetória válida
+    bool open(const std::string& filePath);
+    void close();
+
+    size_t size() const { return Count; }
+    size_t chunkCount() const { return Chunks; }
+    uint32_t flags() const { return Flags; }
+    uint32_t chunkPoints() const { return ChunkPoints; }
+    bool hasTimestamps() const { return (Flags & TRAJECTORY_TIMESTAMPS) != 0; }
+
+    // Decodificam só os bytes pedidos: páginas não lidas nem chegam à memória
+    glm::vec3 point(size_t i) const;
+    double time(size_t i) const; // 0 sem TRAJECTORY_TIMESTAMPS
+    void readPoints(size_t first, size_t count, glm::vec3* out) const;
+    void readAll(std::vector<glm::vec3>& points) const;
+
+    // Primeiro ponto com tempo >= t (size() se nenhum): busca binária nos
+    // cabeçalhos dos blocos e depois dentro do bloco
+    size_t findTime(double t) const;
+
+private:
+    const char* chunk(size_t c) const { return File.data() + HeaderBytes + c * ChunkBytes; }
+
+    MappedFile File;
+    uint32_t Flags = 0;
+    uint32_t ChunkPoints = 0;
+    size_t ChunkBytes = 0;
+    size_t Chunks = 0;
+    size_t Count = 0;
+    static const size_t HeaderBytes = 32;
+};
+
+// Acrescenta pontos a um .traj sem reescrever o que já está gravado
+class TrajectoryWriter {
+public:
+    TrajectoryWriter() = default;
+    ~TrajectoryWriter();
+
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    // Continua um arquivo existente ou cria um novo (flags e chunkPoints só
+    // valem na criação; num arquivo existente valem os dele)
+    bool open(const std::string& filePath, uint32_t flags = 0, uint32_t chunkPoints = 4096);
+    // Com TRAJECTORY_TIMESTAMPS os tempos precisam crescer (findTime faz busca
+    // binária): um tempo menor que o do último ponto é trocado por ele
+    bool append(const glm::vec3& point, double time = 0.0);
+    // Grava o bloco incompleto; até lá os pontos dele só estão na memória
+    bool flush();
+    void close();
+
+    bool isOpen() const { return File.is_open(); }
+    size_t size() const { return FullChunks * ChunkPoints + Pending.size(); }
+    // Tempo do último ponto (inclusive dos já gravados, ao continuar um arquivo)
+    double lastTime() const { return LastTime; }
+
+private:
+    bool writeChunk();
+
+    std::fstream File;
+    std::string FilePath;
+    uint32_t Flags = 0;
+    uint32_t ChunkPoints = 4096;
+    size_t ChunkBytes = 0;
+    size_t FullChunks = 0;
+    std::vector<glm::vec3> Pending; // pontos do último bloco
+    std::vector<double> PendingTimes;
+    double LastTime = 0.0;
+    bool Dirty = false;
+};
+
+// trajetoria.txt (x y z por linha) -> .traj. Retorna quantos pontos, ou -1 na falha.
+long convertTextTrajectory(const std::string& textPath, const std::string& binaryPath, uint32_t flags = 0,
+                           uint32_t chunkPoints = 4096);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef TRANSFORM_STORE_H
+#define TRANSFORM_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Transformações (posição, rotação em ângulos de Euler X/Y/Z e escala uniforme)
+// guardadas como estrutura de arrays: cada componente em um vetor próprio.
+// Alterar um objeto só o marca como sujo; update() recalcula a matriz model
+// apenas dos objetos marcados, quatro por vez com SSE2.
+//
+// A matriz é a mesma da cadeia usada nos exercícios:
+//   translate(p) * rotate(rx, X) * rotate(ry, Y) * rotate(rz, Z) * scale(s)
+class TransformStore {
+public:
+    // Retorna o índice do novo objeto (já marcado como sujo)
+    size_t add(const glm::vec3& position, const glm::vec3& rotation = glm::vec3(0.0f), float scale = 1.0f);
+    void reserve(size_t count);
+    void clear();
+    size_t size() const { return PosX.size(); }
+
+    glm::vec3 position(size_t i) const { return glm::vec3(PosX[i], PosY[i], PosZ[i]); }
+    glm::vec3 rotation(size_t i) const { return glm::vec3(RotX[i], RotY[i], RotZ[i]); }
+    float scale(size_t i) const { return Scale[i]; }
+
+    void setPosition(size_t i, const glm::vec3& position);
+    void setRotation(size_t i, const glm::vec3& rotation);
+    void setScale(size_t i, float scale);
+    void markDirty(size_t i) { Dirty[i >> 6] |= 1ull << (i & 63); }
+    void markAllDirty();
+    bool isDirty(size_t i) const { return (Dirty[i >> 6] >> (i & 63)) & 1; }
+
+    // Recalcula as matrizes sujas. Retorna quantas foram atualizadas; com
+    // changed != nullptr, os índices delas são acrescentados ali.
+    size_t update(std::vector<uint32_t>* changed = nullptr);
+
+    const glm::mat4& matrix(size_t i) const { return Matrices[i]; }
+    const glm::mat4* matrices() const { return Matrices.data(); }
+
+private:
+    void composeScalar(size_t i);
+    void composeBatch(const uint32_t* indices);
+
+    std::vector<float> PosX, PosY, PosZ;
+    std::vector<float> RotX, RotY, RotZ;
+    std::vector<float> Scale;
+    std::vector<uint64_t> Dirty; // um bit por objeto
+    std::vector<glm::mat4> Matrices;
+};
+
+// Versão escalar da mesma composição, usada como referência
+glm::mat4 composeTRS(const glm::vec3& position, const glm::vec3& rotation, float scale);
+
+#endif
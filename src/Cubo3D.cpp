@@ -5,6 +5,10 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "GLExtras.h"
+#include "AppWindow.h"
+#include "ShaderCache.h"
+#include "InstanceBuffer.h"
 
 using namespace std;
 
@@ -20,15 +24,15 @@ const char* vertexShaderSource = R"(
 #version 450 core
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 color;
+layout (location = 3) in mat4 instanceModel;
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
 out vec4 finalColor;
 
 void main() {
-    gl_Position = projection * view * model * vec4(position, 1.0);
+    gl_Position = projection * view * instanceModel * vec4(position, 1.0);
     finalColor = vec4(color, 1.0);
 }
 )";
@@ -49,19 +53,22 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 GLuint setupShader();
 GLuint setupGeometry();
 
-int main() {
-    glfwInit();
-    GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Cubo 3D - Pedro Fleck", nullptr, nullptr);
+int main(int argc, char** argv) {
+    // --headless e --frames N (a GLFW é inicializada em createAppWindow)
+    parseAppOptions(argc, argv);
+    GLFWwindow* window = createAppWindow(WIDTH, HEIGHT, "Cubo 3D - Pedro Fleck");
+    if (!window)
+        return -1;
     glfwMakeContextCurrent(window);
     glfwSetKeyCallback(window, key_callback);
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+    loadGLExtras((GLADloadproc)glfwGetProcAddress);
 
     glViewport(0, 0, WIDTH, HEIGHT);
     glEnable(GL_DEPTH_TEST);
 
     GLuint shaderProgram = setupShader();
     GLuint VAO = setupGeometry();
-    GLint modelLoc = glGetUniformLocation(shaderProgram, "model");
     GLint viewLoc = glGetUniformLocation(shaderProgram, "view");
     GLint projLoc = glGetUniformLocation(shaderProgram, "projection");
 
@@ -74,6 +81,11 @@ int main() {
         {-2.0f, -1.0f, 1.0f} // Cubo estático 2
     };
 
+    // Os três cubos saem em uma única chamada instanciada
+    InstanceBuffer instanceBuffer;
+    instanceBuffer.attach(VAO);
+    std::vector<InstanceData> instances(cubePositions.size());
+
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
         glClearColor(1, 1, 1, 1);
@@ -85,7 +97,8 @@ int main() {
 
         float angle = glfwGetTime();
 
-        for (auto pos : cubePositions) {
+        for (size_t i = 0; i < cubePositions.size(); ++i) {
+            glm::vec3 pos = cubePositions[i];
             glm::mat4 model = glm::mat4(1.0f);
             glm::vec3 modelPos = pos;
 
@@ -100,14 +113,17 @@ int main() {
                 model = glm::translate(model, modelPos);
             }
 
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glBindVertexArray(VAO);
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            instances[i].model = model;
         }
+        instanceBuffer.update(instances.data(), instances.size());
+
+        glBindVertexArray(VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, instanceBuffer.count());
 
-        glfwSwapBuffers(window);
+        presentFrame(window);
     }
 
+    instanceBuffer.release();
     glDeleteVertexArrays(1, &VAO);
     glfwTerminate();
     return 0;
@@ -133,22 +149,7 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 }
 
 GLuint setupShader() {
-    GLuint vShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vShader);
-
-    GLuint fShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fShader);
-
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vShader);
-    glAttachShader(shaderProgram, fShader);
-    glLinkProgram(shaderProgram);
-
-    glDeleteShader(vShader);
-    glDeleteShader(fShader);
-    return shaderProgram;
+    return createShaderProgram(vertexShaderSource, fragmentShaderSource);
 }
 
 GLuint setupGeometry() {
@@ -1,7 +1,6 @@
 
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <string>
 #include <vector>
 #include <assert.h>
@@ -19,103 +18,23 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 using namespace glm;
 
 #include <cmath>
 #include <algorithm>
+#include "ObjLoader.h"
+#include "GLExtras.h"
+#include "AppWindow.h"
+#include "ShaderCache.h"
+#include "ShaderProgram.h"
+#include "TextureStreamer.h"
+#include "TextureCache.h"
 
 std::string textureFileName = "../assets/tex/pixelWall.png";
 
-int loadSimpleOBJ(string filePATH, int &nVertices)
-{
-    std::vector<glm::vec3> vertices;
-    std::vector<glm::vec2> texCoords;
-    std::vector<GLfloat> vBuffer;
-
-    std::ifstream arqEntrada(filePATH.c_str());
-    if (!arqEntrada.is_open()) {
-        std::cerr << "Erro ao tentar ler o arquivo " << filePATH << std::endl;
-        return -1;
-    }
-
-    std::string line;
-    std::string mtlFile;
-    while (std::getline(arqEntrada, line)) {
-        std::istringstream ssline(line);
-        std::string word;
-        ssline >> word;
-
-        if (word == "v") {
-            glm::vec3 vertice;
-            ssline >> vertice.x >> vertice.y >> vertice.z;
-            vertices.push_back(vertice);
-        } else if (word == "vt") {
-            glm::vec2 vt;
-            ssline >> vt.s >> vt.t;
-            texCoords.push_back(vt);
-        } else if (word == "f") {
-            while (ssline >> word) {
-                int vi = 0, ti = 0;
-                std::replace(word.begin(), word.end(), '/', ' ');
-                std::istringstream indices(word);
-                indices >> vi >> ti;
-                vi--; ti--;
-
-                vBuffer.push_back(vertices[vi].x);
-                vBuffer.push_back(vertices[vi].y);
-                vBuffer.push_back(vertices[vi].z);
-                vBuffer.push_back(texCoords[ti].x);
-                vBuffer.push_back(texCoords[ti].y);
-            }
-        } else if (word == "mtllib") {
-            ssline >> mtlFile;
-        }
-    }
-    arqEntrada.close();
-
-    if (!mtlFile.empty()) {
-        std::ifstream mtlInput(mtlFile.c_str());
-        std::string mtlLine;
-        while (std::getline(mtlInput, mtlLine)) {
-            std::istringstream ssMtl(mtlLine);
-            std::string mtlWord;
-            ssMtl >> mtlWord;
-            if (mtlWord == "map_Kd") {
-                ssMtl >> textureFileName;
-                break;
-            }
-        }
-    }
-
-    GLuint VBO, VAO;
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vBuffer.size() * sizeof(GLfloat), vBuffer.data(), GL_STATIC_DRAW);
-
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(1);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
-    nVertices = vBuffer.size() / 5;
-
-    return VAO;
-}
-
 // Protótipos
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 int setupShader();
-GLuint loadTexture(string filePath, int &width, int &height);
 
 // Dimensões da janela
 const GLuint WIDTH = 800, HEIGHT = 600;
@@ -145,11 +64,14 @@ void main()
     color = texture(texBuff, texCoord);
 })";
 
-int main()
+int main(int argc, char** argv)
 {
-    glfwInit();
+    // --headless e --frames N (a GLFW é inicializada em createAppWindow)
+    parseAppOptions(argc, argv);
 
-    GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "OBJ Texturizado - Pedro Fleck", nullptr, nullptr);
+    GLFWwindow *window = createAppWindow(WIDTH, HEIGHT, "OBJ Texturizado - Pedro Fleck");
+    if (!window)
+        return -1;
     glfwMakeContextCurrent(window);
     glfwSetKeyCallback(window, key_callback);
 
@@ -158,6 +80,7 @@ int main()
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    loadGLExtras((GLADloadproc)glfwGetProcAddress);
 
     const GLubyte *renderer = glGetString(GL_RENDERER);
     const GLubyte *version = glGetString(GL_VERSION);
@@ -168,40 +91,52 @@ int main()
     glfwGetFramebufferSize(window, &width, &height);
     glViewport(0, 0, width, height);
 
-    GLuint shaderID = setupShader();
+    ShaderProgram shader(setupShader());
+    GLuint shaderID = shader.id();
+    GLint modelLoc = shader.location("model");
 
-    int nVertices;
-    GLuint VAO = loadSimpleOBJ("../assets/Modelos3D/Suzanne.obj", nVertices);
+    GLMesh mesh;
+    OBJMaterial material;
+    loadOBJ("../assets/Modelos3D/Suzanne.obj", mesh, &material);
+    if (!material.mapKd.empty())
+        textureFileName = material.mapKd;
 
-    int imgWidth, imgHeight;
-    GLuint texID = loadTexture(textureFileName, imgWidth, imgHeight);
+    TextureStreamer textures;
+    TextureCache textureCache(textures);
+    GLuint texID = textureCache.acquire(textureFileName);
+    // Sem janela a saída precisa ser reprodutível: espera a textura real
+    if (appHeadless())
+        textures.finish();
 
     glUseProgram(shaderID);
-    glUniform1i(glGetUniformLocation(shaderID, "texBuff"), 0);
+    glUniform1i(shader.location("texBuff"), 0);
     glActiveTexture(GL_TEXTURE0);
 
     mat4 projection = ortho(-2.0f, 2.0f,-2.0f, 2.0f,-2.0f, 2.0f);
 
-    glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+    glUniformMatrix4fv(shader.location("projection"), 1, GL_FALSE, value_ptr(projection));
 
     while (!glfwWindowShouldClose(window))
     {
         glfwPollEvents();
+        textures.update();
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
         mat4 model = mat4(1.0f);
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
+        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, value_ptr(model));
 
-        glBindVertexArray(VAO);
         glBindTexture(GL_TEXTURE_2D, texID);
-        glDrawArrays(GL_TRIANGLES, 0, nVertices);
+        drawMesh(mesh);
         glBindVertexArray(0);
 
-        glfwSwapBuffers(window);
+        presentFrame(window);
     }
 
-    glDeleteVertexArrays(1, &VAO);
+    deleteMesh(mesh);
+    textureCache.printStats();
+    textureCache.clear();
+    textures.release();
     glfwTerminate();
     return 0;
 }
@@ -214,75 +149,5 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 
 int setupShader()
 {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    GLint success;
-    GLchar infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    return shaderProgram;
-}
-
-GLuint loadTexture(string filePath, int &width, int &height)
-{
-    GLuint texID;
-    glGenTextures(1, &texID);
-    glBindTexture(GL_TEXTURE_2D, texID);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    int nrChannels;
-    unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-
-    if (data)
-    {
-        if (nrChannels == 3)
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        else
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture " << filePath << std::endl;
-    }
-
-    stbi_image_free(data);
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    return texID;
+    return createShaderProgram(vertexShaderSource, fragmentShaderSource);
 }
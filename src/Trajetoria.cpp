@@ -1,8 +1,9 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <string>
 #include <vector>
+#include <cstring>
+#include <chrono>
 #include <assert.h>
 
 using namespace std;
@@ -18,14 +19,26 @@ using namespace std;
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
 using namespace glm;
 
 #include <cmath>
 #include <algorithm>
 #include "Camera.h"
+#include "ObjLoader.h"
+#include "GLExtras.h"
+#include "AppWindow.h"
+#include "FixedStep.h"
+#include "FrameRecorder.h"
+#include "InstanceBuffer.h"
+#include "PathAgents.h"
+#include "PoseTrack.h"
+#include "SplinePath.h"
+#include "ShaderCache.h"
+#include "ShaderProgram.h"
+#include "TextureStreamer.h"
+#include "TextureCache.h"
+#include "ThreadPool.h"
+#include "TrajectoryFile.h"
 
 std::string textureFileName = "../assets/tex/pixelWall.png";
 float ka = 0.1f, kd = 0.7f, ks = 0.2f, ns = 10.0f;
@@ -38,40 +51,77 @@ Camera camera(glm::vec3(0.0f, 0.0f, 3.0f),
 float lastX = WIDTH / 2.0f;
 float lastY = HEIGHT / 2.0f;
 bool firstMouse = true;
-float deltaTime = 0.0f;
-float lastFrame = 0.0f;
+
+// Câmera e objeto andam em passos fixos de 1/hz s (--hz N, padrão 60); o
+// desenho interpola entre os dois últimos passos, então o resultado não
+// depende da taxa de quadros
+FixedStep fixedStep(60.0);
+vec3 cameraPrevious;
 
 vector<vec3> trajectory;
-int currentPointIndex = 0;
 float moveSpeed = 1.0f;
-vec3 objectPos(0.0f);
-
-void updateTrajectory(float deltaTime) {
-    if (trajectory.empty()) return;
-
-    const vec3& target = trajectory[currentPointIndex];
-    vec3 diff = target - objectPos;
-    float distance = length(diff);
 
-    if (distance < 0.001f) {
-        objectPos = target;
-        currentPointIndex = (currentPointIndex + 1) % trajectory.size();
-        return;
+// Caminho suave pelos pontos da trajetória (--path linear|catmull-rom|bezier),
+// percorrido a velocidade constante pela distância; refeito quando a trajetória muda
+SplinePath path;
+SplineType pathType = SPLINE_CATMULL_ROM;
+
+// --agents N: outros N objetos no mesmo caminho, atualizados em lote e
+// desenhados com uma única chamada instanciada
+PathAgents agents;
+
+void rebuildPath() {
+    // Os agentes guardam trechos do caminho antigo: recria nas mesmas distâncias
+    vector<double> distances(agents.size());
+    vector<float> speeds(agents.size());
+    for (size_t i = 0; i < agents.size(); ++i) {
+        distances[i] = agents.distance(i);
+        speeds[i] = agents.speed(i);
     }
 
-    float step = moveSpeed * deltaTime;
+    path.build(trajectory, pathType, true);
 
-    if (step >= distance) {
-        objectPos = target;
-        currentPointIndex = (currentPointIndex + 1) % trajectory.size();
-    } else {
-        vec3 direction = diff / distance;
-        objectPos += direction * step;
-    }
+    agents.setPath(&path);
+    for (size_t i = 0; i < distances.size(); ++i)
+        agents.add(distances[i], speeds[i]);
+}
+
+// Objeto que percorre o caminho
+struct Follower {
+    double distance = 0.0;      // distância percorrida desde o primeiro ponto
+    vec3 position = vec3(0.0f);
+    vec3 previous = vec3(0.0f); // posição no passo anterior, para interpolar
+};
+Follower follower;
+
+void updateFollower(Follower& f, float step) {
+    if (path.empty()) return;
+    f.distance = path.wrap(f.distance + moveSpeed * step);
+    f.position = path.position(f.distance);
 }
 
 
+// trajetoria.traj (binário, lido do arquivo mapeado) ou texto com x y z por linha
+const char* TRAJECTORY_BINARY = "trajetoria.traj";
+const char* TRAJECTORY_TEXT = "trajetoria.txt";
+TrajectoryWriter trajectoryWriter;
+
 bool loadTrajectoryFromFile(const string& filename) {
+    if (filename.size() > 5 && filename.compare(filename.size() - 5, 5, ".traj") == 0) {
+        TrajectoryReader reader;
+        if (!reader.open(filename)) {
+            cerr << "Erro ao abrir arquivo de trajetória: " << filename << endl;
+            return false;
+        }
+        // Cópia inteira de propósito: a spline precisa de todos os pontos de
+        // controle para ser montada, e a tecla P acrescenta pontos ao vetor.
+        // A leitura em trechos (readPoints) fica para quem percorre gravações
+        // longas sem guardá-las, como o TrajConvert
+        reader.readAll(trajectory);
+        cout << "Trajetória carregada com " << trajectory.size() << " pontos.\n";
+        return true;
+    }
+
     ifstream file(filename);
     if (!file.is_open()) {
         cerr << "Erro ao abrir arquivo de trajetória: " << filename << endl;
@@ -87,37 +137,190 @@ bool loadTrajectoryFromFile(const string& filename) {
     return true;
 }
 
-void processInput(GLFWwindow* window) {
-    float currentFrame = glfwGetTime();
-    deltaTime = currentFrame - lastFrame;
-    lastFrame = currentFrame;
-
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-        camera.ProcessKeyboard(FORWARD, deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-        camera.ProcessKeyboard(BACKWARD, deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-        camera.ProcessKeyboard(LEFT, deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-        camera.ProcessKeyboard(RIGHT, deltaTime);
+// Sem janela (regressão visual) a trajetória é sempre a mesma, a do
+// repositório, e não a que estiver gravada no diretório de trabalho
+const char* HEADLESS_TRAJECTORY = "../assets/trajetoria.txt";
+
+// A gravação em .traj, se já existir, tem prioridade sobre o texto
+bool loadTrajectory() {
+    if (appHeadless())
+        return loadTrajectoryFromFile(HEADLESS_TRAJECTORY);
+    ifstream binary(TRAJECTORY_BINARY);
+    return loadTrajectoryFromFile(binary.is_open() ? TRAJECTORY_BINARY : TRAJECTORY_TEXT);
+}
+
+// Os pontos capturados vão sendo acrescentados ao .traj; só o último bloco do
+// arquivo é reescrito, nunca a trajetória inteira. Os tempos seguem um relógio
+// contínuo entre sessões: cada sessão continua do último tempo gravado, já que
+// o glfwGetTime() volta a zero a cada execução
+const double SEED_POINT_INTERVAL = 1.0; // segundos entre os pontos vindos do texto
+double trajectoryTimeBase = 0.0;
 
+double trajectoryTime() {
+    return trajectoryTimeBase + glfwGetTime();
+}
+
+bool openTrajectoryWriter() {
+    if (trajectoryWriter.isOpen())
+        return true;
+    if (!trajectoryWriter.open(TRAJECTORY_BINARY, TRAJECTORY_TIMESTAMPS))
+        return false;
+    // Arquivo novo: começa com a trajetória carregada do texto, a intervalos fixos
+    if (trajectoryWriter.size() == 0)
+        for (size_t i = 0; i < trajectory.size(); ++i)
+            trajectoryWriter.append(trajectory[i], i * SEED_POINT_INTERVAL);
+    double next = trajectoryWriter.size() > 0 ? trajectoryWriter.lastTime() + SEED_POINT_INTERVAL : 0.0;
+    trajectoryTimeBase = next - glfwGetTime();
+    return true;
+}
+
+// --record-poses arquivo.pose grava a pose do objeto e a da câmera a cada
+// passo (reduzidas a quadros-chave); --play-poses arquivo.pose reproduz a
+// gravação no lugar do teclado e do caminho. O relógio é o da simulação, então
+// a mesma gravação dá sempre os mesmos quadros.
+double simulationTime = 0.0;
+bool recordingPoses = false;
+PoseRecorder objectPoses, cameraPoses;
+vector<PoseTrack> playback; // [0] objeto, [1] câmera
+size_t objectCursor = 0, cameraCursor = 0;
+double playbackTime = HUGE_VAL; // último tempo amostrado; começa sem anterior
+
+// Um passo da simulação: movimento da câmera pelas teclas e do objeto
+void simulate(GLFWwindow* window, float step) {
+    cameraPrevious = camera.Position;
+    follower.previous = follower.position;
+    simulationTime += step;
+
+    if (!playback.empty()) {
+        // Ao terminar, volta ao início da gravação
+        const PoseTrack& object = playback[0];
+        double t = object.startTime() + fmod(simulationTime - object.startTime(), std::max(object.duration(), (double)step));
+        follower.position = object.sample(t, objectCursor).position;
+        if (playback.size() > 1) {
+            Pose view = playback[1].sample(t, cameraCursor);
+            camera.SetPose(view.position, view.orientation);
+        }
+        // No primeiro passo e na volta ao início não há o que interpolar: sem
+        // isso o objeto atravessaria o caminho do fim ao começo em um quadro
+        if (t < playbackTime) {
+            follower.previous = follower.position;
+            cameraPrevious = camera.Position;
+        }
+        playbackTime = t;
+    } else {
+        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+            camera.ProcessKeyboard(FORWARD, step);
+        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+            camera.ProcessKeyboard(BACKWARD, step);
+        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+            camera.ProcessKeyboard(LEFT, step);
+        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+            camera.ProcessKeyboard(RIGHT, step);
+        updateFollower(follower, step);
+    }
+    agents.update(step, &ThreadPool::shared());
+
+    if (recordingPoses) {
+        // O objeto não gira nos exercícios: só a posição dele varia
+        Pose object, view;
+        object.position = follower.position;
+        view.position = camera.Position;
+        view.orientation = camera.GetOrientation();
+        objectPoses.sample(simulationTime, object);
+        cameraPoses.sample(simulationTime, view);
+    }
+}
+
+void processInput(GLFWwindow* window) {
     if (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS) {
         vec3 point = camera.Position + camera.Front * 3.0f;
+        if (openTrajectoryWriter()) {
+            trajectoryWriter.append(point, trajectoryTime());
+            trajectoryWriter.flush();
+        }
         trajectory.push_back(point);
+        rebuildPath();
         glfwWaitEventsTimeout(0.2);
     }
 
     if (glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS) {
-        ofstream file("trajetoria.txt");
-        for (const vec3& p : trajectory) {
-            file << p.x << " " << p.y << " " << p.z << "\n";
-        }
-        file.close();
-        cout << "Trajetória salva com " << trajectory.size() << " pontos.\n";
+        if (openTrajectoryWriter() && trajectoryWriter.flush())
+            cout << "Trajetória salva com " << trajectoryWriter.size() << " pontos em " << TRAJECTORY_BINARY << ".\n";
         glfwWaitEventsTimeout(0.2);
     }
 }
 
+// --bench-update N: só a simulação, sem janela nem desenho. N objetos seguem o
+// caminho, espalhados ao longo dele, por `seconds` segundos simulados em passos
+// fixos: primeiro um Follower por objeto (busca na tabela a cada passo), depois
+// em lote com PathAgents, numa thread e dividido no ThreadPool, incluindo a
+// escrita das matrizes no formato do InstanceBuffer.
+int runUpdateBenchmark(int count, double seconds) {
+    if (trajectory.size() < 2) {
+        trajectory.clear();
+        for (int i = 0; i < 16; ++i) {
+            float angle = 2.0f * pi<float>() * i / 16;
+            trajectory.emplace_back(2.0f * cos(angle), 0.0f, 2.0f * sin(angle));
+        }
+    }
+
+    rebuildPath();
+
+    int steps = std::max(1, (int)(seconds * fixedStep.rate()));
+    float step = fixedStep.step();
+    auto report = [&](const char* name, double ms, vec3 checksum) {
+        cout << name << ": " << count << " objetos, " << steps << " passos de " << 1000.0 * step << " ms: "
+             << ms << " ms (" << ms / steps << " ms por passo, " << 1e6 * ms / ((double)steps * count)
+             << " ns por objeto, " << 1000.0 * seconds / ms << "x o tempo real); soma das posições "
+             << checksum.x << " " << checksum.y << " " << checksum.z << endl;
+    };
+
+    vector<Follower> followers(count);
+    for (int i = 0; i < count; ++i) {
+        followers[i].distance = path.length() * i / count;
+        followers[i].position = path.position(followers[i].distance);
+        followers[i].previous = followers[i].position;
+    }
+    auto start = chrono::steady_clock::now();
+    for (int s = 0; s < steps; ++s) {
+        for (Follower& f : followers) {
+            f.previous = f.position;
+            updateFollower(f, step);
+        }
+    }
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    vec3 checksum(0.0f);
+    for (const Follower& f : followers)
+        checksum += f.position;
+    report("Um a um", ms, checksum);
+    followers = vector<Follower>();
+
+    PathAgents agents;
+    vector<InstanceData> instances(count);
+    ThreadPool* pools[] = {nullptr, &ThreadPool::shared()};
+    for (ThreadPool* pool : pools) {
+        agents.setPath(&path);
+        agents.reserve(count);
+        for (int i = 0; i < count; ++i)
+            agents.add(path.length() * i / count, moveSpeed);
+        double writeMs = 0.0;
+        start = chrono::steady_clock::now();
+        for (int s = 0; s < steps; ++s) {
+            agents.update(step, pool);
+            auto written = chrono::steady_clock::now();
+            agents.writeInstances(instances.data(), 0.2f, vec3(1.0f), pool);
+            writeMs += chrono::duration<double, milli>(chrono::steady_clock::now() - written).count();
+        }
+        ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() - writeMs;
+        checksum = vec3(0.0f);
+        for (int i = 0; i < count; ++i)
+            checksum += agents.position(i);
+        report(pool ? "Em lote, ThreadPool" : "Em lote, 1 thread", ms, checksum);
+        cout << "  + matrizes das instâncias: " << writeMs / steps << " ms por passo" << endl;
+    }
+    return 0;
+}
+
 void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     if (firstMouse) {
         lastX = xpos;
@@ -134,114 +337,9 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     camera.ProcessMouseMovement(xoffset, yoffset);
 }
 
-int loadSimpleOBJ(string filePATH, int &nVertices)
-{
-    std::vector<glm::vec3> vertices;
-    std::vector<glm::vec2> texCoords;
-    std::vector<GLfloat> vBuffer;
-    std::vector<glm::vec3> normals;
-
-    std::ifstream arqEntrada(filePATH.c_str());
-    if (!arqEntrada.is_open()) {
-        std::cerr << "Erro ao tentar ler o arquivo " << filePATH << std::endl;
-        return -1;
-    }
-
-    std::string line;
-    std::string mtlFile;
-    while (std::getline(arqEntrada, line)) {
-        std::istringstream ssline(line);
-        std::string word;
-        ssline >> word;
-
-        if (word == "v") {
-            glm::vec3 vertice;
-            ssline >> vertice.x >> vertice.y >> vertice.z;
-            vertices.push_back(vertice);
-        } else if (word == "vt") {
-            glm::vec2 vt;
-            ssline >> vt.s >> vt.t;
-            texCoords.push_back(vt);
-        } else if (word == "f") {
-            while (ssline >> word) {
-                int vi = 0, ti = 0, ni = 0;
-                std::replace(word.begin(), word.end(), '/', ' ');
-                std::istringstream indices(word);
-                indices >> vi >> ti >> ni;
-                vi--; ti--; ni--;
-
-                vBuffer.push_back(vertices[vi].x);
-                vBuffer.push_back(vertices[vi].y);
-                vBuffer.push_back(vertices[vi].z);
-
-                vBuffer.push_back(texCoords[ti].x);
-                vBuffer.push_back(texCoords[ti].y);
-
-                vBuffer.push_back(normals[ni].x);
-                vBuffer.push_back(normals[ni].y);
-                vBuffer.push_back(normals[ni].z);
-            }
-        } else if (word == "mtllib") {
-            ssline >> mtlFile;
-        } else if (word == "vn") {
-            glm::vec3 normal;
-            ssline >> normal.x >> normal.y >> normal.z;
-            normals.push_back(normal);
-        }
-
-    }
-    arqEntrada.close();
-
-    if (!mtlFile.empty()) {
-        std::ifstream mtlInput(mtlFile.c_str());
-        std::string mtlLine;
-        while (std::getline(mtlInput, mtlLine)) {
-            std::istringstream ssMtl(mtlLine);
-            std::string mtlWord;
-            ssMtl >> mtlWord;
-            if (mtlWord == "map_Kd") {
-                ssMtl >> textureFileName;
-            } else if (mtlWord == "Ka") {
-                ssMtl >> ka;
-            } else if (mtlWord == "Kd") {
-                ssMtl >> kd;
-            } else if (mtlWord == "Ks") {
-                ssMtl >> ks;
-            } else if (mtlWord == "Ns") {
-                ssMtl >> ns;
-            }
-        }
-    }
-
-    GLuint VBO, VAO;
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vBuffer.size() * sizeof(GLfloat), vBuffer.data(), GL_STATIC_DRAW);
-
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (GLvoid *)0);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(1);
-
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (GLvoid *)(5 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(2);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
-    nVertices = vBuffer.size() / 5;
-
-    return VAO;
-}
-
 // Protótipos
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode);
 int setupShader();
-GLuint loadTexture(string filePath, int &width, int &height);
 
 // Vertex Shader
 const GLchar *vertexShaderSource = R"(
@@ -250,8 +348,18 @@ layout (location = 0) in vec3 position;
 layout (location = 1) in vec2 texc;
 layout (location = 2) in vec3 normal;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout (std140) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+    vec4 lightPos;
+    vec4 camPos;
+    float ka;
+    float kd;
+    float ks;
+    float q;
+};
+
 uniform mat4 model;
 
 out vec2 texCoord;
@@ -266,19 +374,57 @@ void main()
     vNormal = normal;
 })";
 
+// Mesmo vertex shader, com a matriz model vinda do InstanceBuffer (--agents)
+const GLchar *vertexInstancedSource = R"(
+#version 400
+layout (location = 0) in vec3 position;
+layout (location = 1) in vec2 texc;
+layout (location = 2) in vec3 normal;
+layout (location = 3) in mat4 instanceModel;
+
+layout (std140) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+    vec4 lightPos;
+    vec4 camPos;
+    float ka;
+    float kd;
+    float ks;
+    float q;
+};
+
+out vec2 texCoord;
+out vec3 vNormal;
+out vec4 fragPos;
+
+void main()
+{
+    gl_Position = projection * view * instanceModel * vec4(position, 1.0);
+    fragPos = instanceModel * vec4(position, 1.0);
+    texCoord = texc;
+    vNormal = normal;
+})";
+
 const GLchar *fragmentShaderSource = R"(
 #version 400
 in vec2 texCoord;
 in vec3 vNormal;
 in vec4 fragPos;
 
+layout (std140) uniform FrameData
+{
+    mat4 projection;
+    mat4 view;
+    vec4 lightPos;
+    vec4 camPos;
+    float ka;
+    float kd;
+    float ks;
+    float q;
+};
+
 uniform sampler2D texBuff;
-uniform vec3 lightPos;
-uniform vec3 camPos;
-uniform float ka;
-uniform float kd;
-uniform float ks;
-uniform float q;
 
 out vec4 color;
 
@@ -290,12 +436,12 @@ void main()
     vec3 ambient = ka * lightColor;
 
     vec3 N = normalize(vNormal);
-    vec3 L = normalize(lightPos - vec3(fragPos));
+    vec3 L = normalize(lightPos.xyz - vec3(fragPos));
     float diff = max(dot(N, L), 0.0);
     vec3 diffuse = kd * diff * lightColor;
 
     vec3 R = reflect(-L, N);
-    vec3 V = normalize(camPos - vec3(fragPos));
+    vec3 V = normalize(camPos.xyz - vec3(fragPos));
     float spec = pow(max(dot(R, V), 0.0), q);
     vec3 specular = ks * spec * lightColor;
 
@@ -303,11 +449,48 @@ void main()
     color = vec4(result, 1.0);
 })";
 
-int main()
+int main(int argc, char** argv)
 {
-    glfwInit();
+    // --headless e --frames N (a GLFW é inicializada em createAppWindow)
+    parseAppOptions(argc, argv);
+
+    // --hz N: frequência da simulação; --path linear|catmull-rom|bezier: forma
+    // do caminho; --bench-update N [--bench-seconds S]: mede só a atualização
+    // de N objetos, sem abrir janela; --agents N: N objetos a mais no caminho;
+    // --record-poses / --play-poses arquivo.pose: grava ou reproduz objeto e câmera
+    int benchObjects = 0;
+    int agentCount = 0;
+    string posesPath;
+    double benchSeconds = 10.0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc)
+            fixedStep.setRate(atof(argv[++i]));
+        else if (strcmp(argv[i], "--path") == 0 && i + 1 < argc) {
+            if (!parseSplineType(argv[++i], pathType))
+                cout << "Tipo de caminho desconhecido: " << argv[i] << endl;
+        } else if (strcmp(argv[i], "--bench-update") == 0 && i + 1 < argc)
+            benchObjects = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--bench-seconds") == 0 && i + 1 < argc)
+            benchSeconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--agents") == 0 && i + 1 < argc)
+            agentCount = std::max(0, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--record-poses") == 0 && i + 1 < argc)
+            posesPath = argv[++i];
+        else if (strcmp(argv[i], "--play-poses") == 0 && i + 1 < argc) {
+            if (!loadPoseTracks(argv[++i], playback) || playback.empty() || playback[0].empty()) {
+                cout << "Gravação de poses inválida: " << argv[i] << endl;
+                playback.clear();
+            }
+        }
+    }
+    if (benchObjects > 0) {
+        loadTrajectory();
+        return runUpdateBenchmark(benchObjects, benchSeconds);
+    }
 
-    GLFWwindow *window = glfwCreateWindow(WIDTH, HEIGHT, "Trajetoria - Pedro Fleck", nullptr, nullptr);
+    GLFWwindow *window = createAppWindow(WIDTH, HEIGHT, "Trajetoria - Pedro Fleck");
+    if (!window)
+        return -1;
     glfwMakeContextCurrent(window);
     glfwSetKeyCallback(window, key_callback);
 
@@ -316,6 +499,7 @@ int main()
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    loadGLExtras((GLADloadproc)glfwGetProcAddress);
 
     const GLubyte *renderer = glGetString(GL_RENDERER);
     const GLubyte *version = glGetString(GL_VERSION);
@@ -326,66 +510,166 @@ int main()
     glfwGetFramebufferSize(window, &width, &height);
     glViewport(0, 0, width, height);
 
-    GLuint shaderID = setupShader();
+    ShaderProgram shader(setupShader());
 
-    int nVertices;
-    GLuint VAO = loadSimpleOBJ("../assets/Modelos3D/Suzanne.obj", nVertices);
+    GLMesh mesh;
+    OBJMaterial material;
+    loadOBJ("../assets/Modelos3D/Suzanne.obj", mesh, &material);
+    if (!material.mapKd.empty())
+        textureFileName = material.mapKd;
+    ka = material.ka; kd = material.kd; ks = material.ks; ns = material.ns;
 
-    int imgWidth, imgHeight;
-    GLuint texID = loadTexture(textureFileName, imgWidth, imgHeight);
+    TextureStreamer textures;
+    TextureCache textureCache(textures);
+    GLuint texID = textureCache.acquire(textureFileName);
+    // Sem janela a saída precisa ser reprodutível: espera a textura real
+    if (appHeadless())
+        textures.finish();
 
-    loadTrajectoryFromFile("trajetoria.txt");
+    loadTrajectory();
+    rebuildPath();
+    follower.position = follower.previous = path.position(0.0);
+
+    // Espalhados pelo caminho, com velocidades entre 0.5x e 1.5x a do objeto
+    agents.reserve(agentCount);
+    for (int i = 0; i < agentCount; ++i)
+        agents.add(path.length() * i / agentCount, moveSpeed * (0.5f + (float)((i * 7919) % 1000) / 1000.0f));
 
     vec3 lightPos = vec3(0.6, 1.2, -0.5);
-    vec3 camPos = vec3(0.0, 0.0, -3.0);
-
-    glUseProgram(shaderID);
-    glUniform1i(glGetUniformLocation(shaderID, "texBuff"), 0);
-    glUniform1f(glGetUniformLocation(shaderID, "ka"), ka);
-    glUniform1f(glGetUniformLocation(shaderID, "kd"), kd);
-    glUniform1f(glGetUniformLocation(shaderID, "ks"), ks);
-    glUniform1f(glGetUniformLocation(shaderID, "q"), ns);
-    glUniform3f(glGetUniformLocation(shaderID, "lightPos"), lightPos.x, lightPos.y, lightPos.z);
-    glUniform3f(glGetUniformLocation(shaderID, "camPos"), camera.Position.x, camera.Position.y, camera.Position.z);
+
+    shader.use();
+    glUniform1i(shader.location("texBuff"), 0);
+    GLint modelLoc = shader.location("model");
     glActiveTexture(GL_TEXTURE0);
 
-    mat4 projection = ortho(-2.0f, 2.0f,-2.0f, 2.0f,-2.0f, 2.0f);
+    // Câmera, luz e material vão para o bloco FrameData, enviado uma vez por quadro
+    shader.bindUniformBlock("FrameData", FRAME_UNIFORMS_BINDING);
+    ShaderProgram instancedShader(createShaderProgram(vertexInstancedSource, fragmentShaderSource));
+    instancedShader.use();
+    glUniform1i(instancedShader.location("texBuff"), 0);
+    instancedShader.bindUniformBlock("FrameData", FRAME_UNIFORMS_BINDING);
+    InstanceBuffer instanceBuffer;
+    instanceBuffer.attach(mesh.VAO);
+    shader.use();
 
-    glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+    UniformBuffer frameBuffer;
+    frameBuffer.create(sizeof(FrameUniforms), FRAME_UNIFORMS_BINDING);
+
+    FrameUniforms frame;
+    int reportedVisible = -1;
+    frame.lightPos = vec4(lightPos, 1.0f);
+    frame.ka = ka; frame.kd = kd; frame.ks = ks; frame.q = ns;
 
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetCursorPosCallback(window, mouse_callback);
 
     glEnable(GL_DEPTH_TEST);
+    cameraPrevious = camera.Position;
+
+    // --record pasta (um QOI por quadro) ou --record video.y4m;
+    // --record-format png|qoi|y4m escolhe o formato explicitamente e vale
+    // sobre a extensão, em qualquer ordem
+    FrameRecorder recorder;
+    string recordPath;
+    CaptureFormat recordFormat = CAPTURE_QOI;
+    bool explicitFormat = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--record-format") == 0 && i + 1 < argc) {
+            if (parseCaptureFormat(argv[++i], recordFormat))
+                explicitFormat = true;
+            else
+                cout << "Formato de gravação desconhecido: " << argv[i] << endl;
+        }
+    }
+    if (!explicitFormat && recordPath.size() > 4 && recordPath.compare(recordPath.size() - 4, 4, ".y4m") == 0)
+        recordFormat = CAPTURE_Y4M;
+    if (!recordPath.empty())
+        recorder.start(recordPath, recordFormat, width, height);
+
+    if (!posesPath.empty()) {
+        objectPoses.start(fixedStep.rate());
+        cameraPoses.start(fixedStep.rate());
+        recordingPoses = true;
+    }
+    if (!playback.empty())
+        cout << "Reproduzindo " << playback[0].size() << " quadros-chave (" << playback[0].duration() << " s)" << endl;
 
     while (!glfwWindowShouldClose(window))
     {
         processInput(window);
-        updateTrajectory(deltaTime);
+        int steps = fixedStep.advance(glfwGetTime());
+        for (int i = 0; i < steps; ++i)
+            simulate(window, fixedStep.step());
+        float alpha = fixedStep.alpha();
         glfwPollEvents();
+        textures.update();
         glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        mat4 projection = perspective(glm::radians(45.0f), (float)WIDTH / HEIGHT, 0.1f, 100.0f);
-        mat4 view = camera.GetViewMatrix();
+        frame.projection = perspective(glm::radians(45.0f), (float)WIDTH / HEIGHT, 0.1f, 100.0f);
+        vec3 cameraPos = mix(cameraPrevious, camera.Position, alpha);
+        // No percurso gravado (--camera-play) a câmera é a do quadro, sem interpolar
+        if (driveCamera(camera, cameraPos))
+            cameraPos = cameraPrevious = camera.Position;
+        frame.view = lookAt(cameraPos, cameraPos + camera.Front, camera.Up);
+        frame.camPos = vec4(cameraPos, 1.0f);
+        frameBuffer.update(&frame, sizeof(frame));
 
         glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, objectPos);
+        model = glm::translate(model, mix(follower.previous, follower.position, alpha));
         model = glm::scale(model, glm::vec3(0.2f));
 
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "view"), 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, glm::value_ptr(model));
+        // Objeto fora do volume visível da câmera não é enviado
+        glm::vec3 center;
+        float radius;
+        transformSphere(mesh.bounds, model, center, radius);
+        int visible = sphereInFrustum(extractFrustum(frame.projection * frame.view), center, radius) ? 1 : 0;
+        if (visible != reportedVisible) {
+            cout << "Visíveis: " << visible << ", descartados: " << 1 - visible << endl;
+            reportedVisible = visible;
+        }
+
+        if (visible) {
+            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
+            glBindTexture(GL_TEXTURE_2D, texID);
+            drawMesh(mesh);
+        }
 
-        glBindVertexArray(VAO);
-        glBindTexture(GL_TEXTURE_2D, texID);
-        glDrawArrays(GL_TRIANGLES, 0, nVertices);
+        // Agentes: posições do último passo escritas direto no buffer mapeado
+        if (agents.size() > 0) {
+            if (InstanceData* instances = instanceBuffer.map(agents.size())) {
+                agents.writeInstances(instances, 0.2f, vec3(1.0f), &ThreadPool::shared(), alpha);
+                instanceBuffer.unmap();
+            }
+            instancedShader.use();
+            glBindTexture(GL_TEXTURE_2D, texID);
+            drawMeshInstanced(mesh, instanceBuffer.count());
+            shader.use();
+        }
         glBindVertexArray(0);
 
-        glfwSwapBuffers(window);
+        recorder.capture();
+        presentFrame(window);
     }
 
-    glDeleteVertexArrays(1, &VAO);
+    recorder.stop();
+    trajectoryWriter.close();
+    if (recordingPoses) {
+        vector<PoseTrack> tracks = {objectPoses.finish(), cameraPoses.finish()};
+        if (savePoseTracks(posesPath, tracks))
+            cout << "Poses gravadas em " << posesPath << ": " << objectPoses.samplesRecorded() << " amostras -> "
+                 << tracks[0].size() << " quadros-chave do objeto e " << tracks[1].size() << " da câmera" << endl;
+        else
+            cout << "Erro ao gravar " << posesPath << endl;
+    }
+    deleteMesh(mesh);
+    instanceBuffer.release();
+    frameBuffer.release();
+    textureCache.printStats();
+    textureCache.clear();
+    textures.release();
     glfwTerminate();
     return 0;
 }
@@ -398,75 +682,5 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 
 int setupShader()
 {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-    GLint success;
-    GLchar infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
-
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success)
-    {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    return shaderProgram;
-}
-
-GLuint loadTexture(string filePath, int &width, int &height)
-{
-    GLuint texID;
-    glGenTextures(1, &texID);
-    glBindTexture(GL_TEXTURE_2D, texID);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    int nrChannels;
-    unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-
-    if (data)
-    {
-        if (nrChannels == 3)
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-        else
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-
-        glGenerateMipmap(GL_TEXTURE_2D);
-    }
-    else
-    {
-        std::cout << "Failed to load texture " << filePath << std::endl;
-    }
-
-    stbi_image_free(data);
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    return texID;
+    return createShaderProgram(vertexShaderSource, fragmentShaderSource);
 }
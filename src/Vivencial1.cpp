@@ -1,8 +1,10 @@
 // Vivencial1.cpp - Versão extendida para múltiplos objetos com seleção e transformação e cores diferentes
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
 #include <vector>
 #include <glad/glad.h>
@@ -10,117 +12,72 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "ObjLoader.h"
+#include "GLExtras.h"
+#include "AppWindow.h"
+#include "ShaderCache.h"
+#include "InstanceBuffer.h"
+#include "TransformStore.h"
+#include "GeometryArena.h"
+#include "Bvh.h"
+#include "Profiler.h"
 
 using namespace std;
 
 // Janela
 const GLuint WINDOW_WIDTH = 1000, WINDOW_HEIGHT = 1000;
 
-// === Classe para representar um objeto 3D ===
-struct Object3D {
-    GLuint vao;
-    int vertexCount;
-    glm::vec3 position;
-    glm::vec3 rotation;
-    float scale;
-    glm::vec3 color;
+// === Objetos 3D ===
+// Posição, rotação e escala ficam em estrutura de arrays (TransformStore), que
+// recalcula só as matrizes dos objetos alterados. As malhas ficam todas em uma
+// GeometryArena e a cena inteira sai em uma chamada glMultiDrawElementsIndirect:
+// um comando por malha, com as instâncias (um InstanceData por objeto)
+// agrupadas por malha.
+TransformStore transforms;
+vector<glm::vec3> objectColors;
+vector<int> objectMeshes; // índice em MESH_FILES
+
+const char* const MESH_FILES[] = {
+    "../assets/Modelos3D/Suzanne.obj",
+    "../assets/Modelos3D/Cube.obj",
+    "../assets/Modelos3D/SuzanneSubdiv1.obj",
 };
-
-vector<Object3D> objects;
+const int MESH_COUNT = sizeof(MESH_FILES) / sizeof(MESH_FILES[0]);
 int selectedObjectIndex = 0;
 
-// === Função para carregar arquivos OBJ simples ===
-// Agora recebe a cor do objeto para aplicar no buffer
-int loadSimpleOBJ(string filePATH, int &nVertices, const glm::vec3& color) {
-    vector<glm::vec3> vertices;
-    vector<GLfloat> vBuffer;
-
-    ifstream file(filePATH);
-    if (!file.is_open()) {
-        cerr << "Erro ao abrir o arquivo: " << filePATH << endl;
-        return -1;
-    }
-
-    string line;
-    while (getline(file, line)) {
-        istringstream ss(line);
-        string word;
-        ss >> word;
-
-        if (word == "v") {
-            glm::vec3 vertex;
-            ss >> vertex.x >> vertex.y >> vertex.z;
-            vertices.push_back(vertex);
-        } else if (word == "f") {
-            while (ss >> word) {
-                int vi = 0;
-                stringstream faceSS(word);
-                string index;
-                if (getline(faceSS, index, '/')) {
-                    vi = !index.empty() ? stoi(index) - 1 : 0;
-                }
-                vBuffer.push_back(vertices[vi].x);
-                vBuffer.push_back(vertices[vi].y);
-                vBuffer.push_back(vertices[vi].z);
-                vBuffer.push_back(color.r);
-                vBuffer.push_back(color.g);
-                vBuffer.push_back(color.b);
-            }
-        }
-    }
-
-    file.close();
-
-    GLuint VBO, VAO;
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vBuffer.size() * sizeof(GLfloat), vBuffer.data(), GL_STATIC_DRAW);
-
-    glGenVertexArrays(1, &VAO);
-    glBindVertexArray(VAO);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(GLfloat), (void*)(3 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(1);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
-    nVertices = vBuffer.size() / 6;
-    return VAO;
-}
+// Clique pendente: tratado no laço principal, onde estão view e projection
+bool pickRequested = false;
+double pickX = 0.0, pickY = 0.0;
 
 // === Shaders ===
 const char* vertexShaderSource = R"(
 #version 450 core
 layout (location = 0) in vec3 position;
-layout (location = 1) in vec3 color;
+layout (location = 3) in mat4 instanceModel;
+layout (location = 7) in vec4 instanceColor; // rgb + 1 se selecionado
 
-uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
 out vec3 vertexColor;
+flat out float selected;
 
 void main() {
-    gl_Position = projection * view * model * vec4(position, 1.0);
-    vertexColor = color;
+    gl_Position = projection * view * instanceModel * vec4(position, 1.0);
+    vertexColor = instanceColor.rgb;
+    selected = instanceColor.a;
 }
 )";
 
 const char* fragmentShaderSource = R"(
 #version 450 core
 in vec3 vertexColor;
+flat in float selected;
 out vec4 fragColor;
 
-uniform int selectedObject;
-uniform int currentObject; // passado pelo código para identificar o objeto atual
-
 void main() {
     // Se for o objeto selecionado, destacamos a cor (ex: amarelo)
-    if (selectedObject == currentObject) {
+    if (selected > 0.5) {
         fragColor = vec4(1.0, 1.0, 0.0, 1.0); // amarelo vivo
     } else {
         fragColor = vec4(vertexColor, 1.0);
@@ -129,110 +86,278 @@ void main() {
 )";
 
 void handleKeyboard(GLFWwindow* window, int key, int scancode, int action, int mods);
+void handleMouseButton(GLFWwindow* window, int button, int action, int mods);
 GLuint createShaderProgram();
 void configureOpenGL(GLFWwindow* window);
+void buildStressScene(int count, bool mixedMeshes);
 
 void printInstructions() {
     cout << "===== Controles da Aplicação =====" << endl;
     cout << "TAB           : Selecionar próximo objeto" << endl;
+    cout << "Clique        : Selecionar o objeto sob o cursor" << endl;
     cout << "ESC           : Fechar aplicação" << endl;
     cout << "X, Y, Z       : Rotacionar objeto selecionado nos eixos X, Y e Z" << endl;
     cout << "W, A, S, D    : Mover objeto selecionado para frente, esquerda, trás e direita" << endl;
     cout << "I, J          : Mover objeto selecionado para cima e para baixo" << endl;
     cout << "[             : Diminuir escala do objeto selecionado" << endl;
     cout << "]             : Aumentar escala do objeto selecionado" << endl;
+    cout << "(--stress [N] na linha de comando: N Suzannes e tempo de quadro;" << endl;
+    cout << " com --mixed, Suzannes, cubos e Suzannes subdivididas)" << endl;
+    cout << "(--profile [arquivo.json]: tempos por etapa a cada 5 s e trace do Chrome ao sair)" << endl;
     cout << "===================================" << endl;
 }
 
-int main() {
-    if (!glfwInit()) {
-        cerr << "Falha ao inicializar GLFW" << endl;
-        return -1;
+int main(int argc, char** argv) {
+    // --stress [N]: N Suzannes (100000 por padrão) para medir o tempo de quadro
+    // --mixed: alterna as malhas de MESH_FILES (um comando indireto por malha)
+    // --profile [arquivo.json]: liga o Profiler; o trace é gravado ao fechar
+    // --headless, --frames N: ver AppWindow.h
+    int stressCount = 0;
+    bool mixedMeshes = false;
+    string tracePath;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--stress") == 0) {
+            stressCount = 100000;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0)
+                stressCount = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--mixed") == 0) {
+            mixedMeshes = true;
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            tracePath = "vivencial1_trace.json";
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                tracePath = argv[++i];
+        }
     }
 
-    GLFWwindow* window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Vivencial 1 - Objetos Múltiplos", nullptr, nullptr);
-    if (!window) {
-        cerr << "Falha ao criar janela GLFW" << endl;
-        glfwTerminate();
+    parseAppOptions(argc, argv);
+    GLFWwindow* window = createAppWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Vivencial 1 - Objetos Múltiplos");
+    if (!window)
         return -1;
-    }
 
     configureOpenGL(window);
     printInstructions();
+    Profiler& profiler = Profiler::shared();
+    profiler.setEnabled(!tracePath.empty());
 
     GLuint shader = createShaderProgram();
 
-    GLint modelLoc = glGetUniformLocation(shader, "model");
     GLint viewLoc = glGetUniformLocation(shader, "view");
     GLint projLoc = glGetUniformLocation(shader, "projection");
-    GLint selectedObjLoc = glGetUniformLocation(shader, "selectedObject");
-    GLint currentObjLoc = glGetUniformLocation(shader, "currentObject");
-
-    glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, -8));
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 100.0f);
-
-    vector<glm::vec3> positions = {{-2, 0, 0}, {0, 0, 0}, {2, 0, 0}};
-    vector<glm::vec3> colors = {
-        {1.0f, 0.0f, 0.0f},  // vermelho
-        {0.0f, 1.0f, 0.0f},  // verde
-        {0.0f, 0.0f, 1.0f}   // azul
-    };
-
-    for (size_t i = 0; i < positions.size(); ++i) {
-        int nVerts;
-        GLuint vao = loadSimpleOBJ("../assets/Modelos3D/Suzanne.obj", nVerts, colors[i]);
-        if (vao == -1) return -1;
-
-        Object3D obj;
-        obj.vao = vao;
-        obj.vertexCount = nVerts;
-        obj.position = positions[i];
-        obj.rotation = glm::vec3(0);
-        obj.scale = 1.0f;
-        obj.color = colors[i];
-        objects.push_back(obj);
+
+    float sceneSize = 8.0f;
+    if (stressCount > 0) {
+        buildStressScene(stressCount, mixedMeshes);
+        sceneSize = 3.0f * std::cbrt((float)stressCount);
+        glfwSwapInterval(0); // sem vsync: o tempo de quadro é o da GPU/CPU
+    } else {
+        vector<glm::vec3> positions = {{-2, 0, 0}, {0, 0, 0}, {2, 0, 0}};
+        vector<glm::vec3> colors = {
+            {1.0f, 0.0f, 0.0f},  // vermelho
+            {0.0f, 1.0f, 0.0f},  // verde
+            {0.0f, 0.0f, 1.0f}   // azul
+        };
+
+        for (size_t i = 0; i < positions.size(); ++i) {
+            transforms.add(positions[i]);
+            objectColors.push_back(colors[i]);
+            objectMeshes.push_back(0);
+        }
     }
 
+    glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, -sceneSize));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)WINDOW_WIDTH / WINDOW_HEIGHT, 0.1f, 4.0f * sceneSize + 100.0f);
+
+    GeometryArena arena;
+    vector<ArenaMesh> meshes(MESH_COUNT);
+    {
+        PROFILE_ZONE("carga");
+        for (int m = 0; m < MESH_COUNT; ++m)
+            if (!loadOBJ(MESH_FILES[m], arena, meshes[m])) return -1;
+    }
+
+    InstanceBuffer instanceBuffer;
+    instanceBuffer.attach(arena.vao());
+    vector<InstanceData> instances(transforms.size());
+    IndirectBatch batch;
+
+    // Caixas no espaço do mundo organizadas em uma BVH, usada no descarte e na
+    // seleção pelo mouse; só as caixas dos objetos alterados são reajustadas
+    Bvh bvh;
+    vector<Aabb> worldBoxes(transforms.size());
+    vector<uint32_t> changedObjects, visible, uploaded;
+    size_t visibleCount = 0;
+    int uploadedSelection = -1;
+
+    double reportStart = glfwGetTime();
+    int reportFrames = 0;
+    size_t reportedVisible = (size_t)-1;
+    double profileStart = glfwGetTime();
+
     while (!glfwWindowShouldClose(window)) {
+        profiler.beginFrame();
         glfwPollEvents();
         glClearColor(1, 1, 1, 1);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         glUseProgram(shader);
 
-        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
-        glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-        glUniform1i(selectedObjLoc, selectedObjectIndex);
+        changedObjects.clear();
+        size_t changed;
+        {
+            PROFILE_ZONE("atualiza");
+            changed = transforms.update(&changedObjects);
+            if (bvh.size() != transforms.size()) {
+                for (size_t i = 0; i < transforms.size(); ++i)
+                    worldBoxes[i] = transformAabb(meshes[objectMeshes[i]].bounds, transforms.matrix(i));
+                bvh.build(worldBoxes.data(), worldBoxes.size());
+            } else {
+                for (uint32_t i : changedObjects)
+                    bvh.update(i, transformAabb(meshes[objectMeshes[i]].bounds, transforms.matrix(i)));
+            }
+        }
+
+        // No modo de estresse as instâncias são fixas: só a câmera gira
+        if (stressCount > 0) {
+            view = glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, -sceneSize));
+            view = glm::rotate(view, (float)glfwGetTime() * 0.2f, glm::vec3(0, 1, 0));
+        }
+
+        if (pickRequested) {
+            // Raio do plano near ao far passando pelo pixel clicado
+            glm::mat4 inverseViewProj = glm::inverse(projection * view);
+            float ndcX = 2.0f * (float)pickX / WINDOW_WIDTH - 1.0f;
+            float ndcY = 1.0f - 2.0f * (float)pickY / WINDOW_HEIGHT;
+            glm::vec4 nearPoint = inverseViewProj * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+            glm::vec4 farPoint = inverseViewProj * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+            glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+            glm::vec3 direction = glm::vec3(farPoint) / farPoint.w - origin;
+
+            float distance;
+            int picked = bvh.pick(origin, direction, distance);
+            if (picked >= 0) {
+                selectedObjectIndex = picked;
+                cout << "Objeto selecionado: " << picked << endl;
+            }
+            pickRequested = false;
+        }
+
+        {
+            PROFILE_ZONE("descarte");
+            Frustum frustum = extractFrustum(projection * view);
+            visible.clear();
+            visibleCount = bvh.cull(frustum, visible);
+        }
 
-        for (size_t i = 0; i < objects.size(); ++i) {
-            Object3D& obj = objects[i];
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, obj.position);
-            model = glm::rotate(model, obj.rotation.x, glm::vec3(1, 0, 0));
-            model = glm::rotate(model, obj.rotation.y, glm::vec3(0, 1, 0));
-            model = glm::rotate(model, obj.rotation.z, glm::vec3(0, 0, 1));
-            model = glm::scale(model, glm::vec3(obj.scale));
+        {
+            PROFILE_ZONE("desenho");
+            // Instâncias visíveis agrupadas por malha (um comando indireto por malha);
+            // o buffer só é reenviado quando algo mudou
+            bool sameVisible = uploaded.size() == visibleCount && std::equal(uploaded.begin(), uploaded.end(), visible.begin());
+            if (changed > 0 || uploadedSelection != selectedObjectIndex || !sameVisible) {
+                vector<GLuint> firstInstance(MESH_COUNT + 1, 0);
+                for (size_t v = 0; v < visibleCount; ++v)
+                    firstInstance[objectMeshes[visible[v]] + 1]++;
+                for (int m = 0; m < MESH_COUNT; ++m)
+                    firstInstance[m + 1] += firstInstance[m];
+
+                vector<GLuint> next(firstInstance.begin(), firstInstance.end() - 1);
+                for (size_t v = 0; v < visibleCount; ++v) {
+                    uint32_t i = visible[v];
+                    InstanceData& instance = instances[next[objectMeshes[i]]++];
+                    instance.model = transforms.matrix(i);
+                    instance.color = objectColors[i];
+                    instance.selected = (int)i == selectedObjectIndex && stressCount == 0 ? 1.0f : 0.0f;
+                }
+                instanceBuffer.update(instances.data(), visibleCount);
+
+                batch.clear();
+                for (int m = 0; m < MESH_COUNT; ++m) {
+                    if (firstInstance[m + 1] > firstInstance[m])
+                        batch.add(meshes[m], firstInstance[m + 1] - firstInstance[m], firstInstance[m]);
+                }
+                uploaded.assign(visible.begin(), visible.begin() + visibleCount);
+                uploadedSelection = selectedObjectIndex;
+            }
+
+            glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
+            glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
+
+            {
+                PROFILE_GPU_ZONE("desenho");
+                batch.draw(arena, &instanceBuffer);
+            }
+        }
+
+        if (stressCount == 0 && visibleCount != reportedVisible) {
+            cout << "Visíveis: " << visibleCount << ", descartados: " << transforms.size() - visibleCount << endl;
+            reportedVisible = visibleCount;
+        }
+
+        {
+            PROFILE_ZONE("troca");
+            presentFrame(window);
+        }
+        profiler.endFrame();
 
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-            glUniform1i(currentObjLoc, (int)i);
+        if (!tracePath.empty() && glfwGetTime() - profileStart >= 5.0) {
+            profiler.printStats(cout);
+            profileStart = glfwGetTime();
+        }
 
-            glBindVertexArray(obj.vao);
-            glDrawArrays(GL_TRIANGLES, 0, obj.vertexCount);
+        // No modo headless o relógio é simulado; o tempo real sai no relatório de --frames
+        if (stressCount > 0 && !appHeadless()) {
+            reportFrames++;
+            double now = glfwGetTime();
+            if (now - reportStart >= 1.0) {
+                cout << "Tempo de quadro: " << 1000.0 * (now - reportStart) / reportFrames << " ms ("
+                     << visibleCount << " visíveis, " << transforms.size() - visibleCount << " descartados, "
+                     << batch.size() << " comandos indiretos)" << endl;
+                reportStart = now;
+                reportFrames = 0;
+            }
         }
+    }
 
-        glfwSwapBuffers(window);
+    if (!tracePath.empty()) {
+        profiler.printStats(cout);
+        if (profiler.writeChromeTrace(tracePath))
+            cout << "Trace gravado em " << tracePath << endl;
     }
 
+    profiler.release();
+    batch.release();
+    instanceBuffer.release();
+    arena.release();
     glfwTerminate();
     return 0;
 }
 
+// Grade cúbica de count objetos com rotações e cores variadas
+void buildStressScene(int count, bool mixedMeshes) {
+    int side = (int)std::ceil(std::cbrt((double)count));
+    float spacing = 3.0f;
+    float half = 0.5f * spacing * (side - 1);
+    transforms.reserve(count);
+    objectColors.reserve(count);
+    objectMeshes.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        int x = i % side, y = (i / side) % side, z = i / (side * side);
+        transforms.add(glm::vec3(x * spacing - half, y * spacing - half, z * spacing - half),
+                       glm::vec3(0.0f, glm::radians((float)(i * 37 % 360)), 0.0f));
+        objectColors.push_back(glm::vec3((float)x / side, (float)y / side, (float)z / side));
+        objectMeshes.push_back(mixedMeshes ? i % MESH_COUNT : 0);
+    }
+    cout << "Modo de estresse: " << count << " objetos" << endl;
+}
+
 void configureOpenGL(GLFWwindow* window) {
     glfwMakeContextCurrent(window);
     glfwSetKeyCallback(window, handleKeyboard);
+    glfwSetMouseButtonCallback(window, handleMouseButton);
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         cerr << "Falha ao inicializar GLAD" << endl;
         exit(-1);
     }
+    loadGLExtras((GLADloadproc)glfwGetProcAddress);
     glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
     glEnable(GL_DEPTH_TEST);
 }
@@ -240,62 +365,40 @@ void configureOpenGL(GLFWwindow* window) {
 void handleKeyboard(GLFWwindow* window, int key, int scancode, int action, int mods) {
     if (action != GLFW_PRESS) return;
 
-    Object3D& obj = objects[selectedObjectIndex];
+    size_t selected = (size_t)selectedObjectIndex;
+    glm::vec3 position = transforms.position(selected);
+    glm::vec3 rotation = transforms.rotation(selected);
+    float scale = transforms.scale(selected);
 
     switch (key) {
         case GLFW_KEY_ESCAPE: glfwSetWindowShouldClose(window, true); break;
-        case GLFW_KEY_TAB: selectedObjectIndex = (selectedObjectIndex + 1) % objects.size(); break;
-        case GLFW_KEY_X: obj.rotation.x += glm::radians(15.0f); break;
-        case GLFW_KEY_Y: obj.rotation.y += glm::radians(15.0f); break;
-        case GLFW_KEY_Z: obj.rotation.z += glm::radians(15.0f); break;
-        case GLFW_KEY_W: obj.position.z -= 0.1f; break;
-        case GLFW_KEY_S: obj.position.z += 0.1f; break;
-        case GLFW_KEY_A: obj.position.x -= 0.1f; break;
-        case GLFW_KEY_D: obj.position.x += 0.1f; break;
-        case GLFW_KEY_I: obj.position.y += 0.1f; break;
-        case GLFW_KEY_J: obj.position.y -= 0.1f; break;
-        case GLFW_KEY_LEFT_BRACKET: obj.scale = max(0.1f, obj.scale - 0.1f); break;
-        case GLFW_KEY_RIGHT_BRACKET: obj.scale += 0.1f; break;
+        case GLFW_KEY_TAB: selectedObjectIndex = (selectedObjectIndex + 1) % transforms.size(); break;
+        case GLFW_KEY_X: rotation.x += glm::radians(15.0f); break;
+        case GLFW_KEY_Y: rotation.y += glm::radians(15.0f); break;
+        case GLFW_KEY_Z: rotation.z += glm::radians(15.0f); break;
+        case GLFW_KEY_W: position.z -= 0.1f; break;
+        case GLFW_KEY_S: position.z += 0.1f; break;
+        case GLFW_KEY_A: position.x -= 0.1f; break;
+        case GLFW_KEY_D: position.x += 0.1f; break;
+        case GLFW_KEY_I: position.y += 0.1f; break;
+        case GLFW_KEY_J: position.y -= 0.1f; break;
+        case GLFW_KEY_LEFT_BRACKET: scale = max(0.1f, scale - 0.1f); break;
+        case GLFW_KEY_RIGHT_BRACKET: scale += 0.1f; break;
+        default: return;
     }
-}
 
-GLuint createShaderProgram() {
-    GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertex);
-
-    GLint success;
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(vertex, 512, nullptr, infoLog);
-        cerr << "Erro no vertex shader:\n" << infoLog << endl;
-    }
-
-    GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragment);
-
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetShaderInfoLog(fragment, 512, nullptr, infoLog);
-        cerr << "Erro no fragment shader:\n" << infoLog << endl;
-    }
-
-    GLuint program = glCreateProgram();
-    glAttachShader(program, vertex);
-    glAttachShader(program, fragment);
-    glLinkProgram(program);
+    // Só o objeto alterado tem a matriz recalculada no próximo quadro
+    if (position != transforms.position(selected)) transforms.setPosition(selected, position);
+    if (rotation != transforms.rotation(selected)) transforms.setRotation(selected, rotation);
+    if (scale != transforms.scale(selected)) transforms.setScale(selected, scale);
+}
 
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(program, 512, nullptr, infoLog);
-        cerr << "Erro ao linkar shader program:\n" << infoLog << endl;
-    }
+void handleMouseButton(GLFWwindow* window, int button, int action, int mods) {
+    if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS) return;
+    glfwGetCursorPos(window, &pickX, &pickY);
+    pickRequested = true;
+}
 
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-    return program;
+GLuint createShaderProgram() {
+    return createShaderProgram(vertexShaderSource, fragmentShaderSource);
 }
\ No newline at end of file
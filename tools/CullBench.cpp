@@ -0,0 +1,157 @@
+// CullBench.cpp - compara o descarte por frustum e a seleção por raio feitos
+// objeto a objeto com a BVH (Bvh), incluindo o custo de montar a árvore e de
+// reajustá-la depois de mover uma fração dos objetos. O descarte linear também
+// roda com as esferas envolventes em SSE2 (cullSpheres), a referência mais
+// rápida sem hierarquia; esferas são mais folgadas que as caixas, então ali
+// sobram alguns visíveis a mais.
+//
+// Uso: CullBench [objetos] [repetições]
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cfloat>
+#include <cstdlib>
+#include <random>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Bvh.h"
+
+using namespace std;
+
+template <typename F>
+static double bestOf(int runs, F f)
+{
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto start = chrono::steady_clock::now();
+        f();
+        best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    size_t count = argc > 1 ? (size_t)atol(argv[1]) : 1000000;
+    int runs = argc > 2 ? atoi(argv[2]) : 5;
+
+    mt19937 rng(42);
+    uniform_real_distribution<float> pos(-100.0f, 100.0f), size(0.1f, 2.0f);
+
+    vector<Aabb> boxes(count);
+    for (Aabb& box : boxes) {
+        glm::vec3 center(pos(rng), pos(rng), pos(rng));
+        glm::vec3 half(size(rng), size(rng), size(rng));
+        box.min = center - half;
+        box.max = center + half;
+    }
+
+    Bvh bvh;
+    double buildMs = bestOf(1, [&] { bvh.build(boxes.data(), boxes.size()); });
+
+    // Câmera dentro da cena olhando para um canto: parte dos objetos visível
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1.0f, 0.1f, 150.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(100.0f, 30.0f, 100.0f), glm::vec3(0, 1, 0));
+    Frustum frustum = extractFrustum(projection * view);
+
+    vector<uint32_t> linear, hierarchical;
+    linear.reserve(count);
+    hierarchical.reserve(count);
+    double linearMs = bestOf(runs, [&] {
+        linear.clear();
+        for (size_t i = 0; i < count; ++i)
+            if (classifyAabb(frustum, boxes[i]) != FRUSTUM_OUTSIDE)
+                linear.push_back((uint32_t)i);
+    });
+    double bvhMs = bestOf(runs, [&] {
+        hierarchical.clear();
+        bvh.cull(frustum, hierarchical);
+    });
+    sort(hierarchical.begin(), hierarchical.end());
+    bool cullOk = linear == hierarchical;
+
+    // Mesmos objetos como esferas envolventes, em estrutura de arrays
+    vector<float> sphereX(count), sphereY(count), sphereZ(count), sphereRadius(count);
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 center = (boxes[i].min + boxes[i].max) * 0.5f;
+        sphereX[i] = center.x;
+        sphereY[i] = center.y;
+        sphereZ[i] = center.z;
+        sphereRadius[i] = glm::length(boxes[i].max - center);
+    }
+    vector<uint32_t> spheres(count);
+    size_t sphereVisible = 0;
+    double sphereMs = bestOf(runs, [&] {
+        sphereVisible = cullSpheres(frustum, sphereX.data(), sphereY.data(), sphereZ.data(), sphereRadius.data(), count,
+                                    spheres.data());
+    });
+    // Toda caixa visível está dentro de uma esfera visível
+    cullOk = cullOk && sphereVisible >= linear.size() &&
+             includes(spheres.begin(), spheres.begin() + sphereVisible, linear.begin(), linear.end());
+
+    // Raios aleatórios: o mais próximo por força bruta contra bvh.pick
+    const int RAYS = 100;
+    vector<glm::vec3> origins(RAYS), directions(RAYS);
+    for (int r = 0; r < RAYS; ++r) {
+        origins[r] = glm::vec3(pos(rng), pos(rng), pos(rng));
+        directions[r] = glm::vec3(pos(rng), pos(rng), pos(rng)) - origins[r];
+    }
+    vector<int> linearHits(RAYS), bvhHits(RAYS);
+    vector<float> linearDistances(RAYS), bvhDistances(RAYS);
+    double linearPickMs = bestOf(runs, [&] {
+        for (int r = 0; r < RAYS; ++r) {
+            glm::vec3 invDirection(1.0f / directions[r].x, 1.0f / directions[r].y, 1.0f / directions[r].z);
+            float best = FLT_MAX, t;
+            int hit = -1;
+            for (size_t i = 0; i < count; ++i) {
+                if (rayIntersectsAabb(origins[r], invDirection, boxes[i], best, t) && t < best) {
+                    best = t;
+                    hit = (int)i;
+                }
+            }
+            linearHits[r] = hit;
+            linearDistances[r] = best;
+        }
+    });
+    double bvhPickMs = bestOf(runs, [&] {
+        for (int r = 0; r < RAYS; ++r)
+            bvhHits[r] = bvh.pick(origins[r], directions[r], bvhDistances[r]);
+    });
+    // Caixas empatadas na mesma distância podem dar objetos diferentes
+    bool pickOk = true;
+    for (int r = 0; r < RAYS; ++r)
+        if (linearHits[r] != bvhHits[r] && !(linearHits[r] >= 0 && bvhHits[r] >= 0 && linearDistances[r] == bvhDistances[r]))
+            pickOk = false;
+
+    // 1% dos objetos deslocado: reajuste incremental contra reconstrução
+    size_t movedCount = max<size_t>(1, count / 100);
+    vector<uint32_t> moved(movedCount);
+    for (uint32_t& i : moved)
+        i = (uint32_t)(rng() % count);
+    double refitMs = bestOf(runs, [&] {
+        for (uint32_t i : moved) {
+            glm::vec3 offset(pos(rng) * 0.01f, pos(rng) * 0.01f, pos(rng) * 0.01f);
+            boxes[i].min += offset;
+            boxes[i].max += offset;
+            bvh.update(i, boxes[i]);
+        }
+    });
+    double rebuildMs = bestOf(1, [&] { bvh.build(boxes.data(), boxes.size()); });
+
+    cout << count << " objetos, " << bvh.nodeCount() << " nós (melhor de " << runs << ")" << endl;
+    cout << "  construção da BVH:         " << buildMs << " ms" << endl;
+    cout << "  descarte linear:           " << linearMs << " ms (" << linear.size() << " visíveis)" << endl;
+    cout << "  descarte linear, esferas:  " << sphereMs << " ms (" << sphereVisible << " visíveis, SSE2)" << endl;
+    cout << "  descarte pela BVH:         " << bvhMs << " ms (" << linearMs / bvhMs << "x; "
+         << sphereMs / bvhMs << "x sobre as esferas)" << endl;
+    cout << "  " << RAYS << " raios, linear:         " << linearPickMs << " ms" << endl;
+    cout << "  " << RAYS << " raios, pela BVH:       " << bvhPickMs << " ms (" << linearPickMs / bvhPickMs << "x)" << endl;
+    cout << "  reajuste de " << movedCount << " objetos: " << refitMs << " ms (reconstrução: " << rebuildMs << " ms)" << endl;
+    if (!cullOk || !pickOk)
+        cout << "  ERRO: BVH diverge da busca linear" << endl;
+    return cullOk && pickOk ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+// GoldenTest.cpp - regressão visual dos exercícios. Cada exercício roda sem
+// janela (--headless) por um número fixo de quadros, com o relógio simulado,
+// grava o último quadro (--capture) e a imagem é comparada com a referência
+// em assets/golden. Na falha, grava também uma imagem com os pixels diferentes.
+// Exercício sem referência é falha: as referências são gravadas com --update
+// (alvo golden-update), que roda no Mesa llvmpipe sem precisar de GPU.
+//
+// Uso: GoldenTest [--update] [--allow-missing] [--frames N] [--tolerance T]
+//                 [--max-different F] [--golden pasta] [--bin pasta] [--out pasta] Exercicio...
+//
+//   --update         regrava as referências com a saída atual
+//   --allow-missing  exercício sem referência aparece como SEM REFERÊNCIA, sem
+//                    falhar (para incluir um exercício novo antes da referência)
+//   --tolerance T    diferença máxima por canal (0-255) para o pixel ser igual
+//   --max-different F fração de pixels diferentes aceita (padrão 0.001)
+//
+// Precisa rodar na pasta de build (os exercícios abrem ../assets/...).
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ImageCompare.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+int main(int argc, char** argv)
+{
+    bool update = false, allowMissing = false;
+    int frames = 30;
+    int tolerance = 2;
+    double maxDifferent = 0.001;
+    fs::path goldenDir = "../assets/golden", binDir = ".", outDir = "golden_out";
+    vector<string> exercises;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--update") == 0)
+            update = true;
+        else if (strcmp(argv[i], "--allow-missing") == 0)
+            allowMissing = true;
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frames = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc)
+            tolerance = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-different") == 0 && i + 1 < argc)
+            maxDifferent = atof(argv[++i]);
+        else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc)
+            goldenDir = argv[++i];
+        else if (strcmp(argv[i], "--bin") == 0 && i + 1 < argc)
+            binDir = argv[++i];
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            outDir = argv[++i];
+        else
+            exercises.push_back(argv[i]);
+    }
+    if (exercises.empty()) {
+        cerr << "Uso: GoldenTest [--update] [--allow-missing] [--frames N] [--tolerance T] [--max-different F] "
+                "[--golden pasta] [--bin pasta] [--out pasta] Exercicio..." << endl;
+        return 2;
+    }
+
+    error_code ec;
+    fs::create_directories(outDir, ec);
+    if (update)
+        fs::create_directories(goldenDir, ec);
+
+    int failures = 0, missing = 0;
+    for (const string& name : exercises) {
+        fs::path executable = binDir / name;
+        fs::path capture = outDir / (name + ".png");
+        fs::path log = outDir / (name + ".log");
+        fs::path golden = goldenDir / (name + ".png");
+        fs::remove(capture, ec);
+
+        string command = "\"" + executable.string() + "\" --headless --frames " + to_string(frames) +
+                         " --capture \"" + capture.string() + "\" > \"" + log.string() + "\" 2>&1";
+        auto start = chrono::steady_clock::now();
+        int status = system(command.c_str());
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        RgbaImage actual;
+        if (status != 0 || !loadPng(capture.string(), actual)) {
+            cout << "FALHA " << name << ": execução sem captura (código " << status << ", ver " << log.string() << ")" << endl;
+            failures++;
+            continue;
+        }
+
+        if (update) {
+            fs::copy_file(capture, golden, fs::copy_options::overwrite_existing, ec);
+            if (ec) {
+                cout << "FALHA " << name << ": não foi possível gravar " << golden.string() << endl;
+                failures++;
+            } else {
+                cout << "ATUALIZADO " << name << " -> " << golden.string() << endl;
+            }
+            continue;
+        }
+
+        if (!fs::exists(golden)) {
+            if (allowMissing) {
+                cout << "SEM REFERÊNCIA " << name << ": " << golden.string() << " não existe (rode com --update)" << endl;
+                missing++;
+            } else {
+                cout << "FALHA " << name << ": referência " << golden.string() << " não existe (rode com --update)" << endl;
+                failures++;
+            }
+            continue;
+        }
+        RgbaImage expected;
+        if (!loadPng(golden.string(), expected)) {
+            cout << "FALHA " << name << ": referência ilegível em " << golden.string() << endl;
+            failures++;
+            continue;
+        }
+        if (expected.width != actual.width || expected.height != actual.height) {
+            cout << "FALHA " << name << ": tamanho " << actual.width << "x" << actual.height << ", referência "
+                 << expected.width << "x" << expected.height << endl;
+            failures++;
+            continue;
+        }
+
+        ImageDiff diff = compareImages(expected, actual, tolerance);
+        size_t pixelCount = (size_t)actual.width * actual.height;
+        bool passed = diff.differentPixels <= (size_t)(maxDifferent * pixelCount);
+        cout << (passed ? "OK    " : "FALHA ") << name << ": " << diff.differentPixels << " pixels diferentes ("
+             << 100.0 * diff.differentPixels / pixelCount << "%), diferença máxima " << diff.maxDifference
+             << ", PSNR " << diff.psnr << " dB, " << seconds << " s" << endl;
+        if (!passed) {
+            fs::path diffPath = outDir / (name + "_diff.png");
+            if (savePng(diffPath.string(), diffImage(expected, actual, tolerance)))
+                cout << "      diferenças em " << diffPath.string() << endl;
+            failures++;
+        }
+    }
+
+    cout << exercises.size() - failures - missing << "/" << exercises.size() << " exercícios conferem";
+    if (missing > 0)
+        cout << ", " << missing << " sem referência";
+    cout << endl;
+    return failures == 0 ? 0 : 1;
+}
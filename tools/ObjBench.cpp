@@ -0,0 +1,200 @@
+// ObjBench.cpp - compara o tempo de leitura de um .obj entre a versão antiga
+// (std::getline + std::istringstream, copiada dos exercícios) e o ObjLoader.
+//
+// Uso: ObjBench [arquivo.obj] [repetições]
+//      ObjBench --synthetic saida.obj <megabytes>   gera uma malha em grade do tamanho pedido
+//      ObjBench --threads arquivo.obj [repetições]  mede a leitura com 1, 2, 4... threads
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+#include <glm/glm.hpp>
+
+#include "ObjLoader.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+// Caminho antigo, sem a parte de OpenGL, para servir de referência
+static bool loadStringstreamOBJ(const string& filePATH, vector<GLfloat>& vBuffer)
+{
+    vector<glm::vec3> vertices;
+    vector<glm::vec2> texCoords;
+    vector<glm::vec3> normals;
+
+    ifstream arqEntrada(filePATH.c_str());
+    if (!arqEntrada.is_open())
+        return false;
+
+    string line;
+    while (getline(arqEntrada, line)) {
+        istringstream ssline(line);
+        string word;
+        ssline >> word;
+
+        if (word == "v") {
+            glm::vec3 vertice;
+            ssline >> vertice.x >> vertice.y >> vertice.z;
+            vertices.push_back(vertice);
+        } else if (word == "vt") {
+            glm::vec2 vt;
+            ssline >> vt.s >> vt.t;
+            texCoords.push_back(vt);
+        } else if (word == "f") {
+            while (ssline >> word) {
+                int vi = 0, ti = 0, ni = 0;
+                replace(word.begin(), word.end(), '/', ' ');
+                istringstream indices(word);
+                indices >> vi >> ti >> ni;
+                vi--; ti--; ni--;
+
+                vBuffer.push_back(vertices[vi].x);
+                vBuffer.push_back(vertices[vi].y);
+                vBuffer.push_back(vertices[vi].z);
+                vBuffer.push_back(texCoords[ti].x);
+                vBuffer.push_back(texCoords[ti].y);
+                vBuffer.push_back(normals[ni].x);
+                vBuffer.push_back(normals[ni].y);
+                vBuffer.push_back(normals[ni].z);
+            }
+        } else if (word == "vn") {
+            glm::vec3 normal;
+            ssline >> normal.x >> normal.y >> normal.z;
+            normals.push_back(normal);
+        }
+    }
+    return true;
+}
+
+// Grade de N x N quads (dois triângulos cada) com v/vt/vn, até atingir o tamanho pedido
+static int writeSyntheticOBJ(const string& filePath, size_t megabytes)
+{
+    ofstream out(filePath, ios::binary);
+    if (!out.is_open()) {
+        cerr << "Erro ao criar o arquivo " << filePath << endl;
+        return -1;
+    }
+
+    // ~150 bytes por vértice da grade (v + vt + vn + 2 faces)
+    size_t target = megabytes * 1024 * 1024;
+    size_t n = 2;
+    while ((n + 1) * (n + 1) * 150 < target)
+        n += 16;
+
+    char line[160];
+    for (size_t y = 0; y <= n; ++y) {
+        for (size_t x = 0; x <= n; ++x) {
+            float fx = (float)x / n, fy = (float)y / n;
+            int len = snprintf(line, sizeof(line), "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn 0.000000 0.000000 1.000000\n",
+                               fx * 2.0f - 1.0f, fy * 2.0f - 1.0f, 0.1f * sin(fx * 20.0f) * cos(fy * 20.0f), fx, fy);
+            out.write(line, len);
+        }
+    }
+    for (size_t y = 0; y < n; ++y) {
+        for (size_t x = 0; x < n; ++x) {
+            size_t a = y * (n + 1) + x + 1, b = a + 1, c = a + n + 1, d = c + 1;
+            int len = snprintf(line, sizeof(line), "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\nf %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n",
+                               a, a, a, b, b, b, d, d, d, a, a, a, d, d, d, c, c, c);
+            out.write(line, len);
+        }
+    }
+    cout << "Gerado " << filePath << ": " << (n + 1) * (n + 1) << " vertices, " << 2 * n * n << " triangulos" << endl;
+    return 0;
+}
+
+static int benchmarkThreads(const string& filePath, int repetitions)
+{
+    using Clock = chrono::steady_clock;
+
+    unsigned maxThreads = max(1u, thread::hardware_concurrency());
+    double baseMs = 0.0;
+    OBJMesh reference;
+    for (unsigned threads = 1; ; threads = min(threads * 2, maxThreads)) {
+        ThreadPool pool(threads - 1);
+        OBJMesh mesh;
+        Clock::time_point t0 = Clock::now();
+        for (int i = 0; i < repetitions; ++i) {
+            mesh = OBJMesh();
+            if (!parseOBJ(filePath, mesh, &pool))
+                return -1;
+        }
+        double ms = chrono::duration<double, milli>(Clock::now() - t0).count() / repetitions;
+
+        if (threads == 1) {
+            baseMs = ms;
+            reference = mesh;
+        }
+        bool same = mesh.vBuffer == reference.vBuffer && mesh.indices == reference.indices;
+        cout << threads << " thread(s): " << ms << " ms, speedup " << baseMs / ms << "x"
+             << (same ? "" : "  [RESULTADO DIFERENTE]") << endl;
+        if (!same)
+            return 1;
+        if (threads == maxThreads)
+            break;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 3 && string(argv[1]) == "--synthetic")
+        return writeSyntheticOBJ(argv[2], (size_t)max(1, atoi(argv[3])));
+    if (argc > 2 && string(argv[1]) == "--threads")
+        return benchmarkThreads(argv[2], argc > 3 ? max(1, atoi(argv[3])) : 3);
+
+    string filePath = argc > 1 ? argv[1] : "../assets/Modelos3D/SuzanneSubdiv1.obj";
+    int repetitions = argc > 2 ? max(1, atoi(argv[2])) : 20;
+
+    using Clock = chrono::steady_clock;
+
+    vector<GLfloat> reference;
+    Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < repetitions; ++i) {
+        reference.clear();
+        if (!loadStringstreamOBJ(filePath, reference)) {
+            cerr << "Erro ao tentar ler o arquivo " << filePath << endl;
+            return -1;
+        }
+    }
+    double oldMs = chrono::duration<double, milli>(Clock::now() - t0).count() / repetitions;
+
+    OBJMesh mesh;
+    t0 = Clock::now();
+    for (int i = 0; i < repetitions; ++i) {
+        mesh = OBJMesh();
+        parseOBJ(filePath, mesh);
+    }
+    double newMs = chrono::duration<double, milli>(Clock::now() - t0).count() / repetitions;
+
+    // Expande os índices para comparar com a saída antiga (um vértice por canto)
+    vector<GLfloat> expanded;
+    expanded.reserve(mesh.indices.size() * OBJ_VERTEX_STRIDE);
+    for (GLuint index : mesh.indices) {
+        const GLfloat* vertex = mesh.vBuffer.data() + index * OBJ_VERTEX_STRIDE;
+        expanded.insert(expanded.end(), vertex, vertex + OBJ_VERTEX_STRIDE);
+    }
+    bool same = reference == expanded;
+
+    size_t oldBytes = reference.size() * sizeof(GLfloat);
+    size_t indexSize = mesh.nVertices <= 0xFFFF ? sizeof(GLushort) : sizeof(GLuint);
+    size_t newBytes = mesh.vBuffer.size() * sizeof(GLfloat) + mesh.indices.size() * indexSize;
+
+    cout << "Arquivo: " << filePath << endl;
+    cout << "Vertices: " << mesh.nIndices << " -> " << mesh.nVertices << " unicos ("
+         << (double)mesh.nIndices / max(1, mesh.nVertices) << "x)" << endl;
+    cout << "Memoria da GPU: " << oldBytes / 1024 << " KB -> " << newBytes / 1024 << " KB" << endl;
+    cout << "stringstream: " << oldMs << " ms" << endl;
+    cout << "ObjLoader:    " << newMs << " ms" << endl;
+    cout << "Speedup:      " << oldMs / newMs << "x" << endl;
+    cout << "Resultado identico: " << (same ? "sim" : "NAO") << endl;
+
+    return same ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+// SplineBench.cpp - monta caminhos (SplinePath) com muitos pontos de controle
+// e mede o custo da tabela de comprimento de arco, o de cada consulta por
+// distância e o quanto a velocidade fica constante: pontos consecutivos tomados
+// a intervalos fixos de distância devem ficar à mesma distância entre si.
+//
+// Uso: SplineBench [pontos] [consultas] [trechos por segmento]
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+#include <glm/glm.hpp>
+
+#include "SplinePath.h"
+
+using namespace std;
+
+int main(int argc, char** argv)
+{
+    size_t count = argc > 1 ? (size_t)atol(argv[1]) : 100000;
+    size_t queries = argc > 2 ? (size_t)atol(argv[2]) : 1000000;
+    int samples = argc > 3 ? atoi(argv[3]) : 8;
+
+    // Passeio aleatório suave: a direção muda pouco de um ponto para o outro
+    mt19937 rng(42);
+    normal_distribution<float> turn(0.0f, 0.4f);
+    uniform_real_distribution<float> stepLength(0.5f, 2.0f);
+    vector<glm::vec3> points(count);
+    glm::vec3 heading(1.0f, 0.0f, 0.0f);
+    for (size_t i = 1; i < count; ++i) {
+        heading = glm::normalize(heading + glm::vec3(turn(rng), 0.25f * turn(rng), turn(rng)));
+        points[i] = points[i - 1] + heading * stepLength(rng);
+    }
+
+    const SplineType types[] = {SPLINE_LINEAR, SPLINE_CATMULL_ROM, SPLINE_BEZIER};
+    const char* names[] = {"linear", "catmull-rom", "bezier"};
+    for (int i = 0; i < 3; ++i) {
+        SplinePath path;
+        auto start = chrono::steady_clock::now();
+        path.build(points, types[i], true, samples);
+        double buildMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        // Consultas em ordem aleatória (o pior caso para a cache)
+        vector<double> distances(queries);
+        uniform_real_distribution<double> anywhere(0.0, path.length());
+        for (double& d : distances)
+            d = anywhere(rng);
+        glm::vec3 checksum(0.0f);
+        start = chrono::steady_clock::now();
+        for (double d : distances)
+            checksum += path.position(d);
+        double lookupMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        // Velocidade constante: corda entre amostras a cada 0.05 de distância.
+        // Nas curvas mais fechadas a corda é menor que o arco, então o máximo
+        // mede a geometria; a média mede o erro da tabela
+        const double spacing = 0.05;
+        size_t steps = min<size_t>(queries, (size_t)(path.length() / spacing));
+        double worst = 0.0, total = 0.0;
+        glm::vec3 previous = path.position(0.0);
+        start = chrono::steady_clock::now();
+        for (size_t s = 1; s <= steps; ++s) {
+            glm::vec3 current = path.position(s * spacing);
+            double error = fabs(glm::length(current - previous) - spacing) / spacing;
+            worst = max(worst, error);
+            total += error;
+            previous = current;
+        }
+        double walkMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        cout << names[i] << ": " << path.segmentCount() << " segmentos, comprimento " << path.length()
+             << ", tabela em " << buildMs << " ms" << endl;
+        cout << "  " << queries << " consultas aleatórias: " << 1e6 * lookupMs / queries << " ns cada"
+             << " (soma " << checksum.x << ")" << endl;
+        cout << "  " << steps << " passos de " << spacing << ": " << 1e6 * walkMs / max<size_t>(steps, 1)
+             << " ns cada, erro de velocidade médio " << 100.0 * total / max<size_t>(steps, 1) << "%, máximo "
+             << 100.0 * worst << "%" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,317 @@
+// TexBake.cpp - pré-processa imagens (PNG, JPG...) para o formato KTX usado
+// pelo TextureStreamer: cadeia de mipmaps calculada na CPU e blocos S3TC
+// (BC1 para imagens opacas, BC3 com alfa), enviados com glCompressedTexImage2D.
+//
+// Uso: TexBake entrada.png [saida.ktx] [--format auto|bc1|bc3|rgba8]
+//      Sem saída, grava ao lado da entrada trocando a extensão (pixelWall.png -> pixelWall.ktx),
+//      que é onde o TextureStreamer procura.
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <stb_image.h>
+
+#include "KtxFile.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+struct Rgba8Image {
+    int width = 0;
+    int height = 0;
+    vector<uint8_t> pixels; // RGBA, 4 bytes por texel
+};
+
+// Média de 2x2 texels (nível seguinte com metade do tamanho, arredondada para
+// baixo, como no glGenerateMipmap): em dimensões ímpares a última linha/coluna
+// fica de fora; só quando a dimensão é 1 o mesmo texel é usado duas vezes
+static Rgba8Image downsample(const Rgba8Image& src)
+{
+    Rgba8Image dst;
+    dst.width = max(1, src.width / 2);
+    dst.height = max(1, src.height / 2);
+    dst.pixels.resize((size_t)dst.width * dst.height * 4);
+
+    ThreadPool::shared().parallelFor((size_t)dst.height, [&](size_t begin, size_t end) {
+        for (size_t y = begin; y < end; ++y) {
+            const uint8_t* row0 = &src.pixels[(size_t)min<int>(2 * (int)y, src.height - 1) * src.width * 4];
+            const uint8_t* row1 = &src.pixels[(size_t)min<int>(2 * (int)y + 1, src.height - 1) * src.width * 4];
+            uint8_t* out = &dst.pixels[y * dst.width * 4];
+            int x = 0;
+#ifdef __SSE2__
+            // 4 texels de saída (8 de entrada por linha) por iteração, somando em 16 bits
+            if (src.width >= 2 * dst.width) {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i two = _mm_set1_epi16(2);
+                for (; x + 4 <= dst.width; x += 4) {
+                    __m128i a = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+                    __m128i b = _mm_loadu_si128((const __m128i*)(row0 + x * 8 + 16));
+                    __m128i c = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+                    __m128i d = _mm_loadu_si128((const __m128i*)(row1 + x * 8 + 16));
+                    // Soma vertical, depois os pares de texels vizinhos
+                    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(c, zero));
+                    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(c, zero));
+                    __m128i lo2 = _mm_add_epi16(_mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(d, zero));
+                    __m128i hi2 = _mm_add_epi16(_mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(d, zero));
+                    __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+                    __m128i s1 = _mm_add_epi16(_mm_unpacklo_epi64(lo2, hi2), _mm_unpackhi_epi64(lo2, hi2));
+                    s0 = _mm_srli_epi16(_mm_add_epi16(s0, two), 2);
+                    s1 = _mm_srli_epi16(_mm_add_epi16(s1, two), 2);
+                    _mm_storeu_si128((__m128i*)(out + x * 4), _mm_packus_epi16(s0, s1));
+                }
+            }
+#endif
+            for (; x < dst.width; ++x) {
+                int x0 = min(2 * x, src.width - 1) * 4, x1 = min(2 * x + 1, src.width - 1) * 4;
+                for (int c = 0; c < 4; ++c)
+                    out[x * 4 + c] = (uint8_t)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+            }
+        }
+    }, 16);
+    return dst;
+}
+
+// ---- Codificação S3TC -----------------------------------------------------
+
+static uint16_t packRgb565(const float* c)
+{
+    int r = (int)(min(max(c[0], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+    int g = (int)(min(max(c[1], 0.0f), 255.0f) * 63.0f / 255.0f + 0.5f);
+    int b = (int)(min(max(c[2], 0.0f), 255.0f) * 31.0f / 255.0f + 0.5f);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void unpackRgb565(uint16_t v, int* c)
+{
+    int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    c[0] = (r << 3) | (r >> 2);
+    c[1] = (g << 2) | (g >> 4);
+    c[2] = (b << 3) | (b >> 2);
+}
+
+// Bloco de cor BC1 (8 bytes) para 16 texels RGBA: extremos ao longo do eixo
+// principal das cores, recuados 1/16 para reduzir o erro médio
+static void encodeColorBlock(const uint8_t* texels, uint8_t* out)
+{
+    float mean[3] = {0, 0, 0};
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 3; ++c)
+            mean[c] += texels[i * 4 + c] / 16.0f;
+
+    float cov[6] = {0, 0, 0, 0, 0, 0};
+    for (int i = 0; i < 16; ++i) {
+        float r = texels[i * 4] - mean[0], g = texels[i * 4 + 1] - mean[1], b = texels[i * 4 + 2] - mean[2];
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    // Iteração de potência para o autovetor dominante
+    float axis[3] = {1.0f, 1.0f, 1.0f};
+    for (int it = 0; it < 4; ++it) {
+        float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+        float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+        float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+        float m = max(fabsf(x), max(fabsf(y), fabsf(z)));
+        if (m < 1e-6f)
+            break;
+        axis[0] = x / m; axis[1] = y / m; axis[2] = z / m;
+    }
+
+    float minT = 1e30f, maxT = -1e30f;
+    for (int i = 0; i < 16; ++i) {
+        float t = (texels[i * 4] - mean[0]) * axis[0] + (texels[i * 4 + 1] - mean[1]) * axis[1] +
+                  (texels[i * 4 + 2] - mean[2]) * axis[2];
+        minT = min(minT, t);
+        maxT = max(maxT, t);
+    }
+    float lengthSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    float inset = (maxT - minT) / 16.0f;
+    float hiColor[3], loColor[3];
+    for (int c = 0; c < 3; ++c) {
+        hiColor[c] = mean[c] + axis[c] * (maxT - inset) / max(lengthSq, 1e-6f);
+        loColor[c] = mean[c] + axis[c] * (minT + inset) / max(lengthSq, 1e-6f);
+    }
+
+    uint16_t c0 = packRgb565(hiColor), c1 = packRgb565(loColor);
+    if (c0 < c1)
+        swap(c0, c1);
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        int palette[4][3];
+        unpackRgb565(c0, palette[0]);
+        unpackRgb565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestError = 1 << 30;
+            for (int p = 0; p < 4; ++p) {
+                int dr = texels[i * 4] - palette[p][0], dg = texels[i * 4 + 1] - palette[p][1], db = texels[i * 4 + 2] - palette[p][2];
+                int error = dr * dr + dg * dg + db * db;
+                if (error < bestError) {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices |= (uint32_t)best << (2 * i);
+        }
+    }
+
+    memcpy(out, &c0, 2);
+    memcpy(out + 2, &c1, 2);
+    memcpy(out + 4, &indices, 4);
+}
+
+// Bloco de alfa BC3 (8 bytes): extremos min/max e 8 níveis interpolados
+static void encodeAlphaBlock(const uint8_t* texels, uint8_t* out)
+{
+    int a0 = 0, a1 = 255;
+    for (int i = 0; i < 16; ++i) {
+        a0 = max(a0, (int)texels[i * 4 + 3]);
+        a1 = min(a1, (int)texels[i * 4 + 3]);
+    }
+
+    uint64_t indices = 0;
+    if (a0 != a1) {
+        int palette[8] = {a0, a1};
+        for (int p = 1; p < 7; ++p)
+            palette[p + 1] = ((7 - p) * a0 + p * a1) / 7;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestError = 1 << 30;
+            for (int p = 0; p < 8; ++p) {
+                int error = abs(texels[i * 4 + 3] - palette[p]);
+                if (error < bestError) {
+                    bestError = error;
+                    best = p;
+                }
+            }
+            indices |= (uint64_t)best << (3 * i);
+        }
+    }
+
+    out[0] = (uint8_t)a0;
+    out[1] = (uint8_t)a1;
+    for (int b = 0; b < 6; ++b)
+        out[2 + b] = (uint8_t)(indices >> (8 * b));
+}
+
+static vector<uint8_t> encodeBlocks(const Rgba8Image& image, bool withAlpha)
+{
+    int blocksX = (image.width + 3) / 4, blocksY = (image.height + 3) / 4;
+    size_t blockBytes = withAlpha ? 16 : 8;
+    vector<uint8_t> out((size_t)blocksX * blocksY * blockBytes);
+
+    ThreadPool::shared().parallelFor((size_t)blocksY, [&](size_t begin, size_t end) {
+        uint8_t texels[16 * 4];
+        for (size_t by = begin; by < end; ++by) {
+            for (int bx = 0; bx < blocksX; ++bx) {
+                // Blocos na borda repetem o último texel válido
+                for (int i = 0; i < 16; ++i) {
+                    int x = min(bx * 4 + (i & 3), image.width - 1);
+                    int y = min((int)by * 4 + (i >> 2), image.height - 1);
+                    memcpy(texels + i * 4, &image.pixels[((size_t)y * image.width + x) * 4], 4);
+                }
+                uint8_t* block = &out[(by * blocksX + bx) * blockBytes];
+                if (withAlpha) {
+                    encodeAlphaBlock(texels, block);
+                    encodeColorBlock(texels, block + 8);
+                } else {
+                    encodeColorBlock(texels, block);
+                }
+            }
+        }
+    });
+    return out;
+}
+
+int main(int argc, char** argv)
+{
+    string input, output, format = "auto";
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc)
+            format = argv[++i];
+        else if (input.empty())
+            input = arg;
+        else
+            output = arg;
+    }
+    if (input.empty() || (format != "auto" && format != "bc1" && format != "bc3" && format != "rgba8")) {
+        cerr << "Uso: TexBake entrada.png [saida.ktx] [--format auto|bc1|bc3|rgba8]" << endl;
+        return -1;
+    }
+    if (output.empty())
+        output = filesystem::path(input).replace_extension(".ktx").string();
+
+    using Clock = chrono::steady_clock;
+    Clock::time_point t0 = Clock::now();
+
+    Rgba8Image level;
+    int channels;
+    unsigned char* data = stbi_load(input.c_str(), &level.width, &level.height, &channels, 4);
+    if (!data) {
+        cerr << "Failed to load texture " << input << endl;
+        return -1;
+    }
+    level.pixels.assign(data, data + (size_t)level.width * level.height * 4);
+    stbi_image_free(data);
+
+    bool hasAlpha = false;
+    for (size_t i = 3; i < level.pixels.size() && !hasAlpha; i += 4)
+        hasAlpha = level.pixels[i] != 255;
+    if (format == "auto")
+        format = hasAlpha ? "bc3" : "bc1";
+
+    KtxImage ktx;
+    ktx.baseFormat = hasAlpha || format == "bc3" ? GL_RGBA : GL_RGB;
+    if (format == "rgba8") {
+        ktx.internalFormat = GL_RGBA8;
+        ktx.format = GL_RGBA;
+        ktx.type = GL_UNSIGNED_BYTE;
+        ktx.baseFormat = GL_RGBA;
+    } else {
+        ktx.internalFormat = format == "bc3" ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+    }
+
+    size_t rawBytes = 0;
+    while (true) {
+        vector<uint8_t> bytes = format == "rgba8" ? level.pixels : encodeBlocks(level, format == "bc3");
+
+        KtxLevel entry;
+        entry.width = level.width;
+        entry.height = level.height;
+        entry.offset = ktx.data.size();
+        entry.size = bytes.size();
+        ktx.data.insert(ktx.data.end(), bytes.begin(), bytes.end());
+        ktx.levels.push_back(entry);
+        rawBytes += level.pixels.size();
+
+        if (level.width == 1 && level.height == 1)
+            break;
+        level = downsample(level);
+    }
+
+    if (!writeKTX(output, ktx)) {
+        cerr << "Erro ao gravar " << output << endl;
+        return -1;
+    }
+
+    double ms = chrono::duration<double, milli>(Clock::now() - t0).count();
+    cout << input << " -> " << output << " (" << format << ", " << ktx.levels.size() << " niveis)" << endl;
+    cout << "Memoria da GPU: " << rawBytes / 1024 << " KB (RGBA8 + mipmaps) -> " << ktx.data.size() / 1024
+         << " KB (" << (double)rawBytes / max<size_t>(1, ktx.data.size()) << "x), " << ms << " ms" << endl;
+    return 0;
+}
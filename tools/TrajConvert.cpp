@@ -0,0 +1,81 @@
+// TrajConvert.cpp - converte trajetórias entre o texto (x y z por linha, o
+// trajetoria.txt dos exercícios) e o formato binário .traj (TrajectoryFile).
+// O sentido sai da extensão da entrada.
+//
+// Uso: TrajConvert entrada.txt saida.traj [--quantize] [--chunk N]
+//      TrajConvert entrada.traj saida.txt
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "TrajectoryFile.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static bool endsWith(const string& text, const string& suffix)
+{
+    return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    vector<string> paths;
+    uint32_t flags = 0, chunkPoints = 4096;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quantize") == 0)
+            flags |= TRAJECTORY_QUANTIZED;
+        else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc)
+            chunkPoints = (uint32_t)atoi(argv[++i]);
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.size() != 2) {
+        cerr << "Uso: TrajConvert entrada.txt saida.traj [--quantize] [--chunk N]\n"
+                "     TrajConvert entrada.traj saida.txt" << endl;
+        return 2;
+    }
+
+    auto start = chrono::steady_clock::now();
+    long count;
+    if (endsWith(paths[0], ".traj")) {
+        TrajectoryReader reader;
+        if (!reader.open(paths[0])) {
+            cerr << "Arquivo de trajetória inválido: " << paths[0] << endl;
+            return 1;
+        }
+        ofstream text(paths[1]);
+        if (!text.is_open()) {
+            cerr << "Erro ao criar " << paths[1] << endl;
+            return 1;
+        }
+        // 9 dígitos significativos: o texto devolve exatamente os mesmos floats
+        text << setprecision(9);
+        // Em blocos, para não decodificar tudo de uma vez
+        vector<glm::vec3> points(reader.chunkPoints());
+        for (size_t first = 0; first < reader.size(); first += points.size()) {
+            size_t n = min(points.size(), reader.size() - first);
+            reader.readPoints(first, n, points.data());
+            for (size_t i = 0; i < n; ++i)
+                text << points[i].x << " " << points[i].y << " " << points[i].z << "\n";
+        }
+        count = (long)reader.size();
+    } else {
+        count = convertTextTrajectory(paths[0], paths[1], flags, chunkPoints);
+        if (count < 0)
+            return 1;
+    }
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    error_code ec;
+    cout << count << " pontos: " << paths[0] << " (" << fs::file_size(paths[0], ec) << " bytes) -> " << paths[1]
+         << " (" << fs::file_size(paths[1], ec) << " bytes) em " << ms << " ms" << endl;
+    return 0;
+}
@@ -0,0 +1,108 @@
+// TransformBench.cpp - compara a montagem das matrizes model pela cadeia
+// glm::translate/rotate/rotate/rotate/scale (como nos exercícios) com o
+// TransformStore (estrutura de arrays + SSE2), para todos os objetos e para
+// uma fração deles marcada como suja.
+//
+// Uso: TransformBench [objetos] [repetições]
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "TransformStore.h"
+
+using namespace std;
+
+struct Object3D {
+    glm::vec3 position;
+    glm::vec3 rotation;
+    float scale;
+};
+
+static glm::mat4 glmChain(const Object3D& obj)
+{
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, obj.position);
+    model = glm::rotate(model, obj.rotation.x, glm::vec3(1, 0, 0));
+    model = glm::rotate(model, obj.rotation.y, glm::vec3(0, 1, 0));
+    model = glm::rotate(model, obj.rotation.z, glm::vec3(0, 0, 1));
+    model = glm::scale(model, glm::vec3(obj.scale));
+    return model;
+}
+
+template <typename F>
+static double bestOf(int runs, F f)
+{
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto start = chrono::steady_clock::now();
+        f();
+        best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    size_t count = argc > 1 ? (size_t)atol(argv[1]) : 1000000;
+    int runs = argc > 2 ? atoi(argv[2]) : 5;
+
+    mt19937 rng(42);
+    uniform_real_distribution<float> pos(-100.0f, 100.0f), angle(-6.3f, 6.3f), scale(0.1f, 3.0f);
+
+    vector<Object3D> objects(count);
+    TransformStore store;
+    store.reserve(count);
+    for (Object3D& obj : objects) {
+        obj.position = glm::vec3(pos(rng), pos(rng), pos(rng));
+        obj.rotation = glm::vec3(angle(rng), angle(rng), angle(rng));
+        obj.scale = scale(rng);
+        store.add(obj.position, obj.rotation, obj.scale);
+    }
+
+    vector<glm::mat4> reference(count);
+    double glmMs = bestOf(runs, [&] {
+        for (size_t i = 0; i < count; ++i)
+            reference[i] = glmChain(objects[i]);
+    });
+
+    double allMs = bestOf(runs, [&] {
+        store.markAllDirty();
+        store.update();
+    });
+
+    // Diferença máxima entre os dois caminhos (relativa à escala do objeto)
+    float maxError = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        const glm::mat4& a = reference[i];
+        const glm::mat4& b = store.matrix(i);
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                maxError = max(maxError, fabs(a[c][r] - b[c][r]) / (c == 3 ? max(1.0f, fabs(a[c][r])) : objects[i].scale));
+    }
+
+    // 10% dos objetos alterados por quadro, espalhados
+    size_t dirtyCount = count / 10;
+    vector<size_t> dirty(dirtyCount);
+    for (size_t& i : dirty)
+        i = rng() % count;
+    double partialMs = bestOf(runs, [&] {
+        for (size_t i : dirty)
+            store.markDirty(i);
+        store.update();
+    });
+
+    cout << count << " objetos (melhor de " << runs << ")" << endl;
+    cout << "  glm (translate/rotate x3/scale): " << glmMs << " ms" << endl;
+    cout << "  TransformStore, todos:           " << allMs << " ms (" << glmMs / allMs << "x)" << endl;
+    cout << "  TransformStore, 10% sujos:       " << partialMs << " ms" << endl;
+    cout << "  erro máximo: " << maxError << endl;
+    return maxError < 1e-4f ? 0 : 1;
+}